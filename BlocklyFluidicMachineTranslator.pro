@@ -35,13 +35,69 @@ unix {
 HEADERS += \
     blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h \
     blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator_global.h \
+    blocklyFluidicMachineTranslator/blocks/deferredfunctionsstore.h \
     blocklyFluidicMachineTranslator/blocks/functionsdblockstranslator.h \
-    blocklyFluidicMachineTranslator/blocks/inputsblockstranslator.h
+    blocklyFluidicMachineTranslator/blocks/inputsblockstranslator.h \
+    blocklyFluidicMachineTranslator/blocks/pluginfunctioncache.h \
+    blocklyFluidicMachineTranslator/blocks/truthtablecache.h \
+    blocklyFluidicMachineTranslator/translationcontext.h \
+    blocklyFluidicMachineTranslator/translationlimits.h \
+    blocklyFluidicMachineTranslator/translationmonitor.h \
+    blocklyFluidicMachineTranslator/graph/componentpartition.h \
+    blocklyFluidicMachineTranslator/graph/machinefingerprint.h \
+    blocklyFluidicMachineTranslator/graph/machinefingerprintbuilder.h \
+    blocklyFluidicMachineTranslator/graph/nodereordering.h \
+    blocklyFluidicMachineTranslator/graph/portset.h \
+    blocklyFluidicMachineTranslator/io/decompressingstreambuf.h \
+    blocklyFluidicMachineTranslator/ir/blocklyjsonexporter.h \
+    blocklyFluidicMachineTranslator/ir/machinegraphbackend.h \
+    blocklyFluidicMachineTranslator/ir/machineir.h \
+    blocklyFluidicMachineTranslator/ir/machineirimage.h \
+    blocklyFluidicMachineTranslator/json/indexedfieldsextractor.h \
+    blocklyFluidicMachineTranslator/json/jsondocumentparser.h \
+    blocklyFluidicMachineTranslator/json/jsonlimitsscanner.h \
+    blocklyFluidicMachineTranslator/json/jsonschema.h \
+    blocklyFluidicMachineTranslator/modules/modulecache.h \
+    blocklyFluidicMachineTranslator/modules/modularmachinetranslator.h \
+    blocklyFluidicMachineTranslator/profiling/phasecounters.h \
+    blocklyFluidicMachineTranslator/prolog/translationstackpool.h \
+    blocklyFluidicMachineTranslator/registry/frozenmachine.h \
+    blocklyFluidicMachineTranslator/registry/machineoverlay.h \
+    blocklyFluidicMachineTranslator/registry/machineregistry.h \
+    blocklyFluidicMachineTranslator/tracing/tracer.h
 
 SOURCES += \
     blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.cpp \
+    blocklyFluidicMachineTranslator/blocks/deferredfunctionsstore.cpp \
     blocklyFluidicMachineTranslator/blocks/functionsdblockstranslator.cpp \
-    blocklyFluidicMachineTranslator/blocks/inputsblockstranslator.cpp
+    blocklyFluidicMachineTranslator/blocks/inputsblockstranslator.cpp \
+    blocklyFluidicMachineTranslator/blocks/pluginfunctioncache.cpp \
+    blocklyFluidicMachineTranslator/blocks/truthtablecache.cpp \
+    blocklyFluidicMachineTranslator/translationcontext.cpp \
+    blocklyFluidicMachineTranslator/translationlimits.cpp \
+    blocklyFluidicMachineTranslator/translationmonitor.cpp \
+    blocklyFluidicMachineTranslator/graph/componentpartition.cpp \
+    blocklyFluidicMachineTranslator/graph/machinefingerprint.cpp \
+    blocklyFluidicMachineTranslator/graph/machinefingerprintbuilder.cpp \
+    blocklyFluidicMachineTranslator/graph/nodereordering.cpp \
+    blocklyFluidicMachineTranslator/graph/portset.cpp \
+    blocklyFluidicMachineTranslator/io/decompressingstreambuf.cpp \
+    blocklyFluidicMachineTranslator/ir/blocklyjsonexporter.cpp \
+    blocklyFluidicMachineTranslator/ir/machinegraphbackend.cpp \
+    blocklyFluidicMachineTranslator/ir/machineir.cpp \
+    blocklyFluidicMachineTranslator/ir/machineirimage.cpp \
+    blocklyFluidicMachineTranslator/json/indexedfieldsextractor.cpp \
+    blocklyFluidicMachineTranslator/json/jsondocumentparser.cpp \
+    blocklyFluidicMachineTranslator/json/jsonlimitsscanner.cpp \
+    blocklyFluidicMachineTranslator/json/jsonschema.cpp \
+    blocklyFluidicMachineTranslator/modules/modulecache.cpp \
+    blocklyFluidicMachineTranslator/modules/modularmachinetranslator.cpp \
+    blocklyFluidicMachineTranslator/profiling/phasecounters.cpp \
+    blocklyFluidicMachineTranslator/prolog/translationstackpool.cpp \
+    blocklyFluidicMachineTranslator/registry/frozenmachine.cpp \
+    blocklyFluidicMachineTranslator/registry/machineoverlay.cpp \
+    blocklyFluidicMachineTranslator/registry/machineregistry.cpp \
+    blocklyFluidicMachineTranslator/tracing/tracer.cpp
 
 debug {
     QMAKE_POST_LINK=X:\blockly_fluidicMachine_translator\blocklyFluidicMachineTranslator\setDLL.bat $$shell_path($$OUT_PWD/debug) debug
@@ -93,6 +149,40 @@ debug {
     LIBS += -L$$quote(X:\bioblocksTranslation\dll_release\bin) -lbioblocksTranslation
 }
 
+# qmake CONFIG+=simdjson parses the input with simdjson instead of the nlohmann parser
+simdjson {
+    DEFINES += BLOCKLYTRANSLATOR_WITH_SIMDJSON
+
+    INCLUDEPATH += X:\libraries\simdjson\include
+    LIBS += -L$$quote(X:\libraries\simdjson\lib) -lsimdjson
+}
+
+# qmake CONFIG+=gzip and/or CONFIG+=zstd accept gzip and/or zstd compressed input files
+gzip {
+    DEFINES += BLOCKLYTRANSLATOR_WITH_ZLIB
+
+    INCLUDEPATH += X:\libraries\zlib\include
+    LIBS += -L$$quote(X:\libraries\zlib\lib) -lz
+}
+
+zstd {
+    DEFINES += BLOCKLYTRANSLATOR_WITH_ZSTD
+
+    INCLUDEPATH += X:\libraries\zstd\include
+    LIBS += -L$$quote(X:\libraries\zstd\lib) -lzstd
+}
+
+# the pre-forked TranslationProcessPool needs fork and unix sockets
+unix {
+    HEADERS += blocklyFluidicMachineTranslator/process/translationprocesspool.h
+    SOURCES += blocklyFluidicMachineTranslator/process/translationprocesspool.cpp
+}
+
+# qmake CONFIG+=tracing compiles in the trace spans, see tracing/tracer.h
+tracing {
+    DEFINES += BLOCKLYTRANSLATOR_TRACING
+}
+
 INCLUDEPATH += X:\libraries\cereal-1.2.2\include
 INCLUDEPATH += X:\libraries\json-2.1.1\src
 
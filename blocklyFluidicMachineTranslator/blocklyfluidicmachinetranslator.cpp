@@ -6,11 +6,57 @@ const std::string BlocklyFluidicMachineTranslator::OPEN_CONTAINER_STR = "OPEN_CO
 const std::string BlocklyFluidicMachineTranslator::CLOSE_CONTAINER_STR = "CLOSE_CONTAINER";
 const std::string BlocklyFluidicMachineTranslator::PUMP_STR = "PUMP";
 const std::string BlocklyFluidicMachineTranslator::VALVE_STR = "VALVE";
+const std::string BlocklyFluidicMachineTranslator::PART_COPY_STR = "part_copy";
+
+//approximate footprint of a node and of a connected port in the maps of the translation, used by
+//TranslationLimits::maxEstimatedMemory
+const size_t BlocklyFluidicMachineTranslator::NODE_MEMORY_ESTIMATE = 1024;
+const size_t BlocklyFluidicMachineTranslator::PORT_MEMORY_ESTIMATE = 128;
+const int BlocklyFluidicMachineTranslator::MAX_COPY_LEVEL = 9;
+
+namespace {
+enum HeaderFields { DEFAULT_RATE, DEFAULT_RATE_VOLUME_UNITS, DEFAULT_RATE_TIME_UNITS, INTEGER_PRECISSION, DECIMAL_PRECISSION,
+                    HEADER_CONNECTIONS, HEADER_NUMBER_BLOCKS };
+enum BlockFields { BLOCK_REFERENCE, BLOCK_TYPE, BLOCK_FUNCTIONS, BLOCK_NUMBER_PINS, BLOCK_IN_PORTS, BLOCK_OUT_PORTS,
+                   BLOCK_EXTRA_FUNCTIONS, BLOCK_NUMBER_TWINS };
+enum ReferenceFields { REFERENCE_REFERENCE, REFERENCE_BLOCK_TYPE };
+}
+
+const JsonSchema BlocklyFluidicMachineTranslator::HEADER_SCHEMA({
+                                                                    "default_rate",
+                                                                    "default_rate_volume_units",
+                                                                    "default_rate_time_units",
+                                                                    "integer_precission",
+                                                                    "decimal_precission"},
+                                                                {"connections", "number_blocks"});
+const JsonSchema BlocklyFluidicMachineTranslator::BLOCK_SCHEMA({
+                                                                   "reference",
+                                                                   "type",
+                                                                   "functions",
+                                                                   "number_pins",
+                                                                   "in_ports",
+                                                                   "out_ports"},
+                                                               {"extra_functions", "number_twins"});
+const JsonSchema BlocklyFluidicMachineTranslator::REFERENCE_SCHEMA({"reference"}, {"block_type"});
 
 BlocklyFluidicMachineTranslator::BlocklyFluidicMachineTranslator(const std::string & path, std::shared_ptr<PluginAbstractFactory> factory) :
+    BlocklyFluidicMachineTranslator(path, std::make_shared<const TranslationContext>(factory))
+{
+
+}
+
+BlocklyFluidicMachineTranslator::BlocklyFluidicMachineTranslator(const std::string & path, std::shared_ptr<const TranslationContext> context) :
     path(path)
 {
-    this->factory = factory;
+    this->context = context;
+    this->nodeOrdering = context->getNodeOrdering();
+    this->stackPool = context->getStackPool();
+    this->limits = context->getLimits();
+    this->hardwareCountersEnabled = false;
+    this->lazyExtraFunctions = false;
+    this->fingerprintEnabled = false;
+    this->portConnections = 0;
+    this->estimatedMemory = 0;
 }
 
 BlocklyFluidicMachineTranslator::~BlocklyFluidicMachineTranslator() {
@@ -18,114 +64,666 @@ BlocklyFluidicMachineTranslator::~BlocklyFluidicMachineTranslator() {
 }
 
 BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::translateFile() {
-    std::ifstream in(path);
-    json js;
+    return translateFile(std::shared_ptr<TranslationMonitor>());
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::translateFile(MachineFingerprint & fingerprint) {
+    return translateFile(std::shared_ptr<TranslationMonitor>(), fingerprint);
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::translateFile(
+        std::shared_ptr<TranslationMonitor> monitor,
+        MachineFingerprint & fingerprint)
+{
+    bool enabled = fingerprintEnabled;
+    fingerprintEnabled = true;
+    try {
+        ModelMappingTuple modelMapping = translateFile(monitor);
+        fingerprintEnabled = enabled;
+        fingerprint = this->fingerprint;
+        return modelMapping;
+    } catch (...) {
+        fingerprintEnabled = enabled;
+        throw;
+    }
+}
+
+std::future<BlocklyFluidicMachineTranslator::ModelMappingTuple> BlocklyFluidicMachineTranslator::translateFileAsync(
+        std::shared_ptr<TranslationMonitor> monitor)
+{
+    return std::async(std::launch::async, [this, monitor]() {
+        return translateFile(monitor);
+    });
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::translateFile(
+        std::shared_ptr<TranslationMonitor> monitor)
+{
+    BLOCKLY_TRACE_SPAN(span, "translateFile");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    resetState();
+    this->monitor = monitor;
+
+    try {
+        json js;
+        JsonSchema::Fields headerFields = readFile(js);
+        return makeModelMapping(headerFields);
+    } catch (TranslationInterruptedException & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::translateFile. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::translateLineDelimitedFile() {
+    return translateLineDelimitedFile(std::shared_ptr<TranslationMonitor>());
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::translateLineDelimitedFile(
+        std::shared_ptr<TranslationMonitor> monitor)
+{
+    BLOCKLY_TRACE_SPAN(span, "translateLineDelimitedFile");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    resetState();
+    this->monitor = monitor;
+
+    std::ifstream in(path, std::ios::in | std::ios::binary);
     try {
-        in >> js;
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "default_rate",
-                                             "default_rate_volume_units",
-                                             "default_rate_time_units",
-                                             "integer_precission",
-                                             "decimal_precission",
-                                             "connections"}, js);
+        DecompressingInputStream input(in, limits.maxInputBytes);
+
+        //the header has none of the checked fields, every other line is a block
+        JsonDocumentParser parser(limits.maxNestingDepth, makeLimitsCheck(std::vector<std::string>()));
+
+        json header;
+        JsonSchema::Fields headerFields;
+        bool headerRead = false;
+
+        int totalBlocks = 0;
+        int processedBlocks = 0;
+
+        int lineNumber = 0;
+        std::string line;
+        while(std::getline(input, line)) {
+            lineNumber++;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            checkInterruption();
+
+            try {
+                if (!headerRead) {
+                    header = parser.parse(line);
+                    headerFields = HEADER_SCHEMA.validate(header);
+                    if (headerFields[HEADER_NUMBER_BLOCKS] != NULL) {
+                        totalBlocks = *headerFields[HEADER_NUMBER_BLOCKS];
+                        TranslationLimits::check(std::max(totalBlocks, 0), limits.maxBlocks, "blocks");
+                    }
+                    model = std::make_shared<MachineGraph>();
+                    headerRead = true;
+                } else {
+                    TranslationLimits::check(processedBlocks + 1, limits.maxBlocks, "blocks");
+
+                    json block;
+                    {
+                        PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::parse);
+                        block = parser.parse(line);
+                    }
+                    processConfigurationBlock(block);
+
+                    processedBlocks++;
+                    if (monitor) {
+                        monitor->reportProgress(processedBlocks, std::max(totalBlocks, processedBlocks));
+                    }
+                }
+            } catch (std::invalid_argument & e) {
+                throw(std::invalid_argument("line " + std::to_string(lineNumber) + ": " + std::string(e.what())));
+            }
+        }
+
+        if (!headerRead) {
+            throw(std::invalid_argument("missing header line"));
+        }
+        return makeModelMapping(headerFields);
+    } catch (TranslationInterruptedException & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::translateLineDelimitedFile. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+void BlocklyFluidicMachineTranslator::resetState() {
+    model.reset();
+    monitor.reset();
+
+    serie = AutoEnumerate();
+    variableIdMap.clear();
+
+    connectionsMap.clear();
+    directedConnectionsMapsIn.clear();
+    directedConnectionsMapsOut.clear();
+    twinsVector.clear();
+
+    pendingNodes.clear();
+    truthTableCache.clear();
+    pluginFunctionCache.clear();
+    edges.clear();
+
+    portConnections = 0;
+    estimatedMemory = 0;
+
+    //built here so the counters follow the thread running the translation
+    phaseCounters = (hardwareCountersEnabled ? std::make_shared<PhaseCounters>() : std::shared_ptr<PhaseCounters>());
+    nodeLabels.clear();
+    fingerprint = MachineFingerprint();
+    valveIds.clear();
+
+    ir.reset();
+    irNodes.clear();
+
+    deferredFunctions = (lazyExtraFunctions ?
+                             std::make_shared<DeferredFunctionsStore>(context->getFactory()) :
+                             std::shared_ptr<DeferredFunctionsStore>());
+}
+
+std::vector<BlocklyFluidicMachineTranslator::ModelMappingTuple> BlocklyFluidicMachineTranslator::translateFileComponents() {
+    return translateFileComponents(std::shared_ptr<TranslationMonitor>());
+}
+
+std::vector<BlocklyFluidicMachineTranslator::ModelMappingTuple> BlocklyFluidicMachineTranslator::translateFileComponents(
+        std::shared_ptr<TranslationMonitor> monitor)
+{
+    BLOCKLY_TRACE_SPAN(span, "translateFileComponents");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    resetState();
+    this->monitor = monitor;
+
+    try {
+        json js;
+        JsonSchema::Fields headerFields = readFile(js);
+        return makeComponentMappings(headerFields);
+    } catch (TranslationInterruptedException & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::translateFileComponents. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+std::shared_ptr<MachineIR> BlocklyFluidicMachineTranslator::translateFileToIR() {
+    return translateFileToIR(std::shared_ptr<TranslationMonitor>());
+}
+
+std::shared_ptr<MachineIR> BlocklyFluidicMachineTranslator::translateFileToIR(std::shared_ptr<TranslationMonitor> monitor) {
+    BLOCKLY_TRACE_SPAN(span, "translateFileToIR");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    resetState();
+    this->monitor = monitor;
+    ir = std::make_shared<MachineIR>();
+
+    try {
+        json js;
+        JsonSchema::Fields headerFields = readFile(js);
+        return makeIR(headerFields);
+    } catch (TranslationInterruptedException & e) {
+        ir.reset();
+        throw;
+    } catch (std::exception & e) {
+        ir.reset();
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::translateFileToIR. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::translateIR(const MachineIR & machineIR) {
+    BLOCKLY_TRACE_SPAN(span, "translateIR");
+
+    resetState();
+    try {
+        const std::vector<std::string> & references = machineIR.getReferences();
+        for(const MachineIR::Node & node : machineIR.getNodes()) {
+            variableIdMap.insert(std::make_pair(references.at(node.reference), node.id));
+        }
+
+        std::shared_ptr<MachineGraph> graph;
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::model_construction);
+            graph = MachineGraphBackEnd::lower(machineIR, context->getFactory(), deferredFunctions);
+        }
+        model = graph;
+        if (fingerprintEnabled) {
+            makeFingerprint(machineIR);
+        }
+
+        PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::model_construction);
+        ModelMappingTuple modelMapping = buildModelMapping(graph, machineIR.getHeader());
+        if (phaseCounters) {
+            phaseCounters->setWorkload(machineIR.getNodes().size(), machineIR.getEdges().size());
+        }
+        return modelMapping;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::translateIR. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+JsonSchema::Fields BlocklyFluidicMachineTranslator::readFile(json & js)
+    throw(std::invalid_argument, TranslationInterruptedException)
+{
+    try {
+        std::ifstream in(path, std::ios::in | std::ios::binary);
+        DecompressingInputStream input(in, limits.maxInputBytes);
+
+        JsonDocumentParser parser(limits.maxNestingDepth, makeLimitsCheck({"connections"}));
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::parse);
+            js = parser.parse(input);
+        }
+
+        JsonSchema::Fields headerFields = HEADER_SCHEMA.validate(js);
+        if (headerFields[HEADER_CONNECTIONS] == NULL) {
+            throw(std::invalid_argument("missing properties: connections"));
+        }
 
         model = std::make_shared<MachineGraph>();
 
-        json connections = js["connections"];
+        const json & connections = *headerFields[HEADER_CONNECTIONS];
+        TranslationLimits::check(connections.size(), limits.maxBlocks, "blocks");
+
+        int totalBlocks = connections.size();
+        int processedBlocks = 0;
         for(auto it = connections.begin(); it != connections.end(); ++it) {
-            json configurationBlock = *it;
+            checkInterruption();
+
+            const json & configurationBlock = *it;
             processConfigurationBlock(configurationBlock);
+
+            processedBlocks++;
+            if (monitor) {
+                monitor->reportProgress(processedBlocks, totalBlocks);
+            }
+        }
+        return headerFields;
+    } catch (TranslationInterruptedException & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::readFile. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::makeModelMapping(const JsonSchema::Fields & headerFields)
+    throw(std::invalid_argument, TranslationInterruptedException)
+{
+    try {
+        renumberNodes();
+
+        size_t blocksNumber = pendingNodes.size();
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::model_construction);
+            addPendingNodes();
+        }
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::connection_map);
+            processConnectionMap(model->getValvesIdsSet());
+        }
+        TranslationLimits::check(edges.size(), limits.maxEdges, "edges");
+        if (fingerprintEnabled) {
+            makeFingerprint();
+        }
+
+        size_t edgesNumber = edges.size();
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::model_construction);
+            addEdges();
+        }
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::twins);
+            processTwins();
+        }
+        checkInterruption();
+
+        PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::model_construction);
+        ModelMappingTuple modelMapping = buildModelMapping(model, makeHeader(headerFields));
+
+        if (phaseCounters) {
+            phaseCounters->setWorkload(blocksNumber, edgesNumber);
+        }
+        return modelMapping;
+    } catch (TranslationInterruptedException & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::makeModelMapping. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+std::vector<BlocklyFluidicMachineTranslator::ModelMappingTuple> BlocklyFluidicMachineTranslator::makeComponentMappings(
+        const JsonSchema::Fields & headerFields) throw(std::invalid_argument, TranslationInterruptedException)
+{
+    BLOCKLY_TRACE_SPAN(span, "partitionComponents");
+
+    try {
+        renumberNodes();
+
+        //the valves are known from the blocks, so every node is only built inside the graph of its component
+        size_t blocksNumber = pendingNodes.size();
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::connection_map);
+            processConnectionMap(valveIds);
+        }
+        TranslationLimits::check(edges.size(), limits.maxEdges, "edges");
+        if (fingerprintEnabled) {
+            makeFingerprint();
+        }
+        size_t edgesNumber = edges.size();
+
+        ComponentPartition partition;
+        for(const auto & pendingPair : pendingNodes) {
+            partition.addNode(pendingPair.first);
+        }
+        for(const EdgeRecord & edge : edges) {
+            partition.unite(edge.source, edge.target);
+        }
+        for(const std::unordered_set<int> & twins : twinsVector) {
+            for(int twin : twins) {
+                partition.unite(*twins.begin(), twin);
+            }
+        }
+
+        std::vector<std::vector<int>> components = partition.getComponents();
+        BLOCKLY_TRACE_ARG(span, "components", components.size());
+
+        std::unordered_map<int, size_t> componentsIndex;
+        std::vector<std::shared_ptr<MachineGraph>> graphs;
+        graphs.reserve(components.size());
+        for(size_t i = 0; i < components.size(); i++) {
+            for(int id : components[i]) {
+                componentsIndex.insert(std::make_pair(id, i));
+            }
+            graphs.push_back(std::make_shared<MachineGraph>());
         }
-        processConnectionMap();
-        processTwins();
 
-        double defaultRate = js["default_rate"];
-        units::Volumetric_Flow defaultRateUnits = UtilsJSON::getVolumeUnits(js["default_rate_volume_units"]) /
-                                                  UtilsJSON::getTimeUnits(js["default_rate_time_units"]);
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::model_construction);
+            for(const auto & pendingPair : pendingNodes) {
+                pendingPair.second(pendingPair.first, *graphs[componentsIndex[pendingPair.first]], deferredFunctions.get());
+            }
+            pendingNodes.clear();
+            for(const EdgeRecord & edge : edges) {
+                graphs[componentsIndex[edge.source]]->connectNodes(edge.source, edge.target, edge.sourcePort, edge.targetPort);
+            }
+            edges.clear();
+        }
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::twins);
+            for(const std::unordered_set<int> & twins : twinsVector) {
+                graphs[componentsIndex[*twins.begin()]]->setValvesAsTwins(twins);
+            }
+        }
+        checkInterruption();
+
+        std::vector<ModelMappingTuple> modelMappings;
+        modelMappings.reserve(graphs.size());
+        MachineIR::Header header = makeHeader(headerFields);
+
+        PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::model_construction);
+        for(const std::shared_ptr<MachineGraph> & graph : graphs) {
+            modelMappings.push_back(buildModelMapping(graph, header));
+            checkInterruption();
+        }
+
+        if (phaseCounters) {
+            phaseCounters->setWorkload(blocksNumber, edgesNumber);
+        }
+        return modelMappings;
+    } catch (TranslationInterruptedException & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::makeComponentMappings. Exception ocurred " + std::string(e.what())));
+    }
+}
 
-        int integerPrecission = js["integer_precission"];
-        int decimalPrecission = js["decimal_precission"];
+std::shared_ptr<MachineIR> BlocklyFluidicMachineTranslator::makeIR(const JsonSchema::Fields & headerFields)
+    throw(std::invalid_argument, TranslationInterruptedException)
+{
+    BLOCKLY_TRACE_SPAN(span, "makeIR");
 
-        std::shared_ptr<PrologTranslationStack> pTranslationStack = std::make_shared<PrologTranslationStack>();
+    try {
+        renumberNodes();
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::connection_map);
+            processConnectionMap(valveIds);
+        }
+        TranslationLimits::check(edges.size(), limits.maxEdges, "edges");
+        if (fingerprintEnabled) {
+            makeFingerprint();
+        }
+        checkInterruption();
 
-        std::shared_ptr<FluidicMachineModel> createdModel =
-                std::make_shared<FluidicMachineModel>(model,
-                                                      pTranslationStack,
-                                                      integerPrecission,
-                                                      decimalPrecission,
-                                                      defaultRate,
-                                                      defaultRateUnits);
-        createdModel->updatePluginFactory(factory);
+        std::unordered_map<int, const std::string *> references;
+        references.reserve(variableIdMap.size());
+        for(const auto & variablePair : variableIdMap) {
+            references.insert(std::make_pair(variablePair.second, &variablePair.first));
+        }
 
-        std::shared_ptr<FluidicModelMapping> mapping = std::make_shared<FluidicModelMapping>(createdModel);
+        std::sort(irNodes.begin(), irNodes.end(), [](const MachineIR::Node & first, const MachineIR::Node & second) {
+            return first.id < second.id;
+        });
+
+        ir->setHeader(makeHeader(headerFields));
+        ir->reserve(irNodes.size(), edges.size());
+        for(const MachineIR::Node & node : irNodes) {
+            ir->addNode(node.id,
+                        static_cast<MachineIR::NodeKind>(node.kind),
+                        node.pins,
+                        directedConnectionsMapsIn.at(node.id),
+                        directedConnectionsMapsOut.at(node.id),
+                        node.functions,
+                        node.extraFunctions,
+                        *references.at(node.id));
+        }
+        for(const EdgeRecord & edge : edges) {
+            ir->addEdge(edge.source, edge.target, edge.sourcePort, edge.targetPort);
+        }
+        edges.clear();
+        for(const std::unordered_set<int> & twins : twinsVector) {
+            ir->addTwins(twins);
+        }
+        irNodes.clear();
 
+        std::shared_ptr<MachineIR> createdIR = ir;
+        ir.reset();
+        return createdIR;
+    } catch (TranslationInterruptedException & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::makeIR. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+void BlocklyFluidicMachineTranslator::addIRNode(
+        int id,
+        const std::string & nodeType,
+        int pinNumber,
+        const JsonSchema::Fields & fields)
+{
+    MachineIR::Node node;
+    node.id = id;
+    if (nodeType.compare(OPEN_CONTAINER_STR) == 0) {
+        node.kind = MachineIR::open_container_node;
+    } else if (nodeType.compare(CLOSE_CONTAINER_STR) == 0) {
+        node.kind = MachineIR::close_container_node;
+    } else if (nodeType.compare(PUMP_STR) == 0) {
+        node.kind = MachineIR::pump_node;
+    } else {
+        node.kind = MachineIR::valve_node;
+    }
+    node.pins = pinNumber;
+    node.firstPort = 0;
+    node.functions = ir->internDescriptor(*fields[BLOCK_FUNCTIONS]);
+    node.extraFunctions = (fields[BLOCK_EXTRA_FUNCTIONS] != NULL ?
+                               ir->internDescriptor(*fields[BLOCK_EXTRA_FUNCTIONS]) :
+                               MachineIR::NO_DESCRIPTOR);
+    node.reference = 0;
+    irNodes.push_back(node);
+}
+
+MachineIR::Header BlocklyFluidicMachineTranslator::makeHeader(const JsonSchema::Fields & headerFields) throw(std::invalid_argument) {
+    try {
+        MachineIR::Header header;
+        header.defaultRate = *headerFields[DEFAULT_RATE];
+        header.rateVolumeUnits = headerFields[DEFAULT_RATE_VOLUME_UNITS]->get<std::string>();
+        header.rateTimeUnits = headerFields[DEFAULT_RATE_TIME_UNITS]->get<std::string>();
+        header.integerPrecission = *headerFields[INTEGER_PRECISSION];
+        header.decimalPrecission = *headerFields[DECIMAL_PRECISSION];
+        return header;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::makeHeader. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::buildModelMapping(
+        std::shared_ptr<MachineGraph> graph,
+        const MachineIR::Header & header) throw(std::invalid_argument)
+{
+    return buildModelMapping(graph, header, stackPool);
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple BlocklyFluidicMachineTranslator::buildModelMapping(
+        std::shared_ptr<MachineGraph> graph,
+        const MachineIR::Header & header,
+        std::shared_ptr<TranslationStackPool> stackPool) throw(std::invalid_argument)
+{
+    try {
+        units::Volumetric_Flow defaultRateUnits = UtilsJSON::getVolumeUnits(header.rateVolumeUnits) /
+                                                  UtilsJSON::getTimeUnits(header.rateTimeUnits);
+
+        std::shared_ptr<PrologTranslationStack> pTranslationStack =
+                (stackPool ? stackPool->lease() : std::make_shared<PrologTranslationStack>());
+
+        std::shared_ptr<FluidicMachineModel> createdModel;
+        {
+            BLOCKLY_TRACE_SPAN(span, "FluidicMachineModel");
+            createdModel = std::make_shared<FluidicMachineModel>(graph,
+                                                                 pTranslationStack,
+                                                                 header.integerPrecission,
+                                                                 header.decimalPrecission,
+                                                                 header.defaultRate,
+                                                                 defaultRateUnits);
+        }
+
+        std::shared_ptr<FluidicModelMapping> mapping;
+        {
+            BLOCKLY_TRACE_SPAN(span, "FluidicModelMapping");
+            mapping = std::make_shared<FluidicModelMapping>(createdModel);
+        }
         return std::make_tuple(createdModel, mapping);
     } catch (std::exception & e) {
-        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::translateFile. Exception ocurred " + std::string(e.what())));
+        throw(std::invalid_argument("BlocklyFluidicMachineTranslator::buildModelMapping. Exception ocurred " + std::string(e.what())));
     }
 }
 
 void BlocklyFluidicMachineTranslator::processConfigurationBlock(const nlohmann::json & blockObj) throw(std::invalid_argument) {
+    BLOCKLY_TRACE_SPAN(span, "processConfigurationBlock");
+    PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::configuration_blocks);
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "reference",
-                                             "type",
-                                             "functions",
-                                             "number_pins"}, blockObj);
+        JsonSchema::Fields fields = BLOCK_SCHEMA.validate(blockObj);
+
+        std::string id = *fields[BLOCK_REFERENCE];
 
-        std::string id = blockObj["reference"];
+        int numberPins = *fields[BLOCK_NUMBER_PINS];
+        if (numberPins < 0) {
+            throw(std::invalid_argument("negative number_pins"));
+        }
+        TranslationLimits::check(numberPins, limits.maxPinsPerNode, "number_pins");
+        addEstimatedMemory(NODE_MEMORY_ESTIMATE + numberPins * PORT_MEMORY_ESTIMATE);
 
-        int numberPins = blockObj["number_pins"];;
+        std::string nodeType = *fields[BLOCK_TYPE];
+        BLOCKLY_TRACE_ARG(span, "reference", id);
+        BLOCKLY_TRACE_ARG(span, "type", nodeType);
 
-        std::string nodeType = blockObj["type"];
+        checkPluginParams(*fields[BLOCK_FUNCTIONS]);
+        if (fields[BLOCK_EXTRA_FUNCTIONS] != NULL) {
+            checkPluginParams(*fields[BLOCK_EXTRA_FUNCTIONS]);
+        }
+        //an IR only interns the descriptors, its functions are built by MachineGraphBackEnd::prepare when it is lowered
         if (nodeType.compare(OPEN_CONTAINER_STR) == 0) {
-            UtilsJSON::checkPropertiesExists(std::vector<std::string>{"extra_functions"}, blockObj);
-            processOpenContainer(id, numberPins, blockObj["functions"], blockObj["extra_functions"]);
+            if (fields[BLOCK_EXTRA_FUNCTIONS] == NULL) {
+                throw(std::invalid_argument("missing properties: extra_functions"));
+            }
+            if (!ir) {
+                processOpenContainer(id, numberPins, *fields[BLOCK_FUNCTIONS], *fields[BLOCK_EXTRA_FUNCTIONS]);
+            }
         } else if (nodeType.compare(CLOSE_CONTAINER_STR) == 0) {
-            UtilsJSON::checkPropertiesExists(std::vector<std::string>{"extra_functions"}, blockObj);
-
-            processCloseContainer(id, numberPins, blockObj["functions"], blockObj["extra_functions"]);
+            if (fields[BLOCK_EXTRA_FUNCTIONS] == NULL) {
+                throw(std::invalid_argument("missing properties: extra_functions"));
+            }
+            if (!ir) {
+                processCloseContainer(id, numberPins, *fields[BLOCK_FUNCTIONS], *fields[BLOCK_EXTRA_FUNCTIONS]);
+            }
         } else if (nodeType.compare(PUMP_STR) == 0) {
-            processPump(id, numberPins, blockObj["functions"]);
+            if (!ir) {
+                processPump(id, numberPins, *fields[BLOCK_FUNCTIONS]);
+            }
         } else if (nodeType.compare(VALVE_STR) == 0) {
-            processValve(id, numberPins, blockObj["functions"]);
-            processValveTwins(id, blockObj);
+            if (!ir) {
+                processValve(id, numberPins, *fields[BLOCK_FUNCTIONS]);
+            }
+            processValveTwins(id, fields[BLOCK_NUMBER_TWINS], blockObj);
+            valveIds.insert(getReferenceId(id));
         } else {
             throw(std::invalid_argument("unknow node type: " + nodeType));
         }
 
-        processDirectionsPorts(id, blockObj);
+        processDirectionsPorts(id, numberPins, *fields[BLOCK_IN_PORTS], *fields[BLOCK_OUT_PORTS]);
+        if (fingerprintEnabled) {
+            addNodeLabel(getReferenceId(id), nodeType, numberPins, fields);
+        }
+        if (ir) {
+            addIRNode(getReferenceId(id), nodeType, numberPins, fields);
+        }
+
+        IndexedFieldsExtractor portsExtractor(1, numberPins);
+        int portPrefix = portsExtractor.addPrefix("port");
+        portsExtractor.extract(blockObj);
+        portsExtractor.checkComplete();
 
+        int idNum = getReferenceId(id);
         for(int i = 1; i <= numberPins; i++) {
-            std::string portName = "port" + std::to_string(i);
-            if(UtilsJSON::hasProperty(portName, blockObj)) {
-                float target = processReferenceBlock(blockObj[portName]);
-                addNewConnection(getReferenceId(id), i-1, target);
-            } else {
-                throw(std::invalid_argument("missing port: " + portName));
-            }
+            float target = processReferenceBlock(*portsExtractor.getField(portPrefix, i));
+            addNewConnection(idNum, i-1, target);
         }
     } catch (std::exception & e) {
         throw(std::invalid_argument("BlocklyFluidicMachineTranslator::processConfigurationBlock. Exception ocurred " + std::string(e.what())));
     }
 }
 
-void BlocklyFluidicMachineTranslator::processDirectionsPorts(const std::string & id, const nlohmann::json & blockObj) throw(std::invalid_argument) {
-    try {
-        UtilsJSON::checkPropertiesExists({"in_ports", "out_ports"}, blockObj);
+void BlocklyFluidicMachineTranslator::processDirectionsPorts(
+        const std::string & id,
+        int pinNumber,
+        const nlohmann::json & inPortsList,
+        const nlohmann::json & outPortsList)
+    throw(std::invalid_argument)
+{
+    //the ports are checked before the insert, the bitmask grows up to the largest port
+    auto checkPort = [&id, pinNumber](int port) {
+        if (port < 1 || port > pinNumber) {
+            throw(std::invalid_argument("port " + std::to_string(port) + " of " + id + " is not between 1 and " +
+                                        std::to_string(pinNumber)));
+        }
+    };
 
-        std::unordered_set<int> inPorts;
-        json inPortsList = blockObj["in_ports"];
+    try {
+        PortSet inPorts;
         for(auto it = inPortsList.begin(); it != inPortsList.end(); ++it) {
             int actualInPort = *it;
+            checkPort(actualInPort);
             inPorts.insert(actualInPort-1);
         }
 
-        std::unordered_set<int> outPorts;
-        json outPortsList = blockObj["out_ports"];
+        PortSet outPorts;
         for(auto it = outPortsList.begin(); it != outPortsList.end(); ++it) {
             int actualInPort = *it;
+            checkPort(actualInPort);
             outPorts.insert(actualInPort-1);
         }
 
@@ -137,38 +735,63 @@ void BlocklyFluidicMachineTranslator::processDirectionsPorts(const std::string &
 
 void BlocklyFluidicMachineTranslator::processPump(const std::string & id, int pinNumber, const nlohmann::json & functionsObj) {
     bool reversible;
-    std::shared_ptr<PumpPluginFunction> pump = FunctionsdBlocksTranslator::processPumpFunction(functionsObj, reversible);
-
-    int idNum = getReferenceId(id);
-    std::shared_ptr<PumpNode> pumpPtr = std::make_shared<PumpNode>(idNum,
-                                                                   pinNumber,
-                                                                   reversible ? PumpNode::bidirectional : PumpNode::unidirectional,
-                                                                   pump);
-    model->addNode(pumpPtr);
+    std::shared_ptr<PumpPluginFunction> pump =
+            FunctionsdBlocksTranslator::processPumpFunction(functionsObj, reversible, context->getFactory(), pluginFunctionCache);
+
+    addPendingNode(getReferenceId(id), [pinNumber, reversible, pump](int nodeId, MachineGraph & graph, DeferredFunctionsStore *) {
+        std::shared_ptr<PumpNode> pumpPtr = std::make_shared<PumpNode>(nodeId,
+                                                                       pinNumber,
+                                                                       reversible ? PumpNode::bidirectional : PumpNode::unidirectional,
+                                                                       pump);
+        graph.addNode(pumpPtr);
+    });
 }
 
 void BlocklyFluidicMachineTranslator::processValve(const std::string & id, int pinNumber, const nlohmann::json & functionsObj) {
-    ValveNode::TruthTable tTable;
-    std::shared_ptr<ValvePluginRouteFunction> valve = FunctionsdBlocksTranslator::processValveFunction(functionsObj, tTable);
-
-    int referenceId = getReferenceId(id);
-    std::shared_ptr<ValveNode> valvePtr = std::make_shared<ValveNode>(referenceId,
-                                                                      pinNumber,
-                                                                      tTable,
-                                                                      valve);
-    model->addNode(valvePtr);
+    TruthTableCache::TruthTablePtr tTable;
+    std::shared_ptr<ValvePluginRouteFunction> valve = FunctionsdBlocksTranslator::processValveFunction(functionsObj,
+                                                                                                       pinNumber,
+                                                                                                       truthTableCache,
+                                                                                                       tTable,
+                                                                                                       context->getFactory(),
+                                                                                                       pluginFunctionCache);
+
+    addPendingNode(getReferenceId(id), [pinNumber, tTable, valve](int nodeId, MachineGraph & graph, DeferredFunctionsStore *) {
+        std::shared_ptr<ValveNode> valvePtr = std::make_shared<ValveNode>(nodeId,
+                                                                          pinNumber,
+                                                                          *tTable,
+                                                                          valve);
+        graph.addNode(valvePtr);
+    });
 }
 
-void BlocklyFluidicMachineTranslator::processValveTwins(const std::string & id, const nlohmann::json & functionsObj) {
-    if (UtilsJSON::hasProperty("number_twins", functionsObj)) {
+void BlocklyFluidicMachineTranslator::processValveTwins(
+        const std::string & id,
+        const nlohmann::json * numberTwinsObj,
+        const nlohmann::json & blockObj)
+{
+    if (numberTwinsObj != NULL) {
         std::unordered_set<int> twins = {getReferenceId(id)};
 
-        int numberTwins = functionsObj["number_twins"];
-        for(int i=0; i < numberTwins; i++) {
+        int numberTwins = *numberTwinsObj;
+        if (numberTwins < 0) {
+            throw(std::invalid_argument("negative number_twins"));
+        }
+        TranslationLimits::check(numberTwins, limits.maxBlocks, "number_twins");
+        //every twin is a field of the block, a larger number can not be filled and would only size the extractor
+        if ((size_t) numberTwins > blockObj.size()) {
+            throw(std::invalid_argument("number_twins " + std::to_string(numberTwins) + " of " + id +
+                                        " is larger than the " + std::to_string(blockObj.size()) + " fields of the block"));
+        }
+
+        IndexedFieldsExtractor twinsExtractor(1, numberTwins);
+        int twinPrefix = twinsExtractor.addPrefix("twin");
+        twinsExtractor.extract(blockObj);
 
-            std::string name = "twin" + std::to_string(i + 1);
-            if (UtilsJSON::hasProperty(name, functionsObj)) {
-                int twinId = std::floorf(processReferenceBlock(functionsObj[name]));
+        for(int i=1; i <= numberTwins; i++) {
+            const json * twinObj = twinsExtractor.getField(twinPrefix, i);
+            if (twinObj != NULL) {
+                int twinId = std::floorf(processReferenceBlock(*twinObj));
                 twins.insert(twinId);
             }
         }
@@ -186,16 +809,33 @@ void BlocklyFluidicMachineTranslator::processOpenContainer(
     units::Volume capacity;
     FunctionsdBlocksTranslator::processOpenGlasswareFunction(functionsObj, minVolume, capacity);
 
-    std::shared_ptr<ContainerNode> nodePtr =
-            std::make_shared<ContainerNode>(getReferenceId(id), pinNumber, ContainerNode::open, capacity);
+    if (deferredFunctions && extraFunctionsObj != nullptr) {
+        DeferredFunctionsStore::Descriptor descriptor = DeferredFunctionsStore::compact(extraFunctionsObj);
+
+        addPendingNode(getReferenceId(id), [pinNumber, capacity, descriptor](int nodeId,
+                                                                             MachineGraph & graph,
+                                                                             DeferredFunctionsStore * store) {
+            std::shared_ptr<ContainerNode> nodePtr =
+                    std::make_shared<ContainerNode>(nodeId, pinNumber, ContainerNode::open, capacity);
+            store->defer(nodeId, nodePtr, descriptor);
+            graph.addNode(nodePtr);
+        });
+        return;
+    }
 
+    std::vector<std::shared_ptr<Function>> functions;
     if (extraFunctionsObj != nullptr) {
-        std::vector<std::shared_ptr<Function>> functions = FunctionsdBlocksTranslator::processFunctions(extraFunctionsObj);
+        functions = FunctionsdBlocksTranslator::processFunctions(extraFunctionsObj, context->getFactory(), pluginFunctionCache);
+    }
+
+    addPendingNode(getReferenceId(id), [pinNumber, capacity, functions](int nodeId, MachineGraph & graph, DeferredFunctionsStore *) {
+        std::shared_ptr<ContainerNode> nodePtr =
+                std::make_shared<ContainerNode>(nodeId, pinNumber, ContainerNode::open, capacity);
         for(auto func : functions) {
             nodePtr->addOperation(func);
         }
-    }
-    model->addNode(nodePtr);
+        graph.addNode(nodePtr);
+    });
 }
 
 void BlocklyFluidicMachineTranslator::processCloseContainer(
@@ -209,28 +849,55 @@ void BlocklyFluidicMachineTranslator::processCloseContainer(
 
     FunctionsdBlocksTranslator::processCloseGlasswareFunction(functionsObj, minVolume, capacity);
 
-    int idNum = getReferenceId(id);
-    std::shared_ptr<ContainerNode> nodePtr =
-            std::make_shared<ContainerNode>(idNum, pinNumber, ContainerNode::close, capacity);
+    if (deferredFunctions && extraFunctionsObj != nullptr) {
+        DeferredFunctionsStore::Descriptor descriptor = DeferredFunctionsStore::compact(extraFunctionsObj);
+
+        addPendingNode(getReferenceId(id), [pinNumber, capacity, descriptor](int nodeId,
+                                                                             MachineGraph & graph,
+                                                                             DeferredFunctionsStore * store) {
+            std::shared_ptr<ContainerNode> nodePtr =
+                    std::make_shared<ContainerNode>(nodeId, pinNumber, ContainerNode::close, capacity);
+            store->defer(nodeId, nodePtr, descriptor);
+            graph.addNode(nodePtr);
+        });
+        return;
+    }
 
+    std::vector<std::shared_ptr<Function>> functions;
     if (extraFunctionsObj != nullptr) {
-        std::vector<std::shared_ptr<Function>> functions = FunctionsdBlocksTranslator::processFunctions(extraFunctionsObj);
+        functions = FunctionsdBlocksTranslator::processFunctions(extraFunctionsObj, context->getFactory(), pluginFunctionCache);
+    }
+
+    addPendingNode(getReferenceId(id), [pinNumber, capacity, functions](int nodeId, MachineGraph & graph, DeferredFunctionsStore *) {
+        std::shared_ptr<ContainerNode> nodePtr =
+                std::make_shared<ContainerNode>(nodeId, pinNumber, ContainerNode::close, capacity);
         for(auto func : functions) {
             nodePtr->addOperation(func);
         }
-    }
-    model->addNode(nodePtr);
+        graph.addNode(nodePtr);
+    });
 }
 
 float BlocklyFluidicMachineTranslator::processReferenceBlock(const nlohmann::json & referenceObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"reference"}, referenceObj);
-
-        if (referenceObj["block_type"] == "part_copy") {
-            return 0.1 + processReferenceBlock(referenceObj["reference"]);
-        } else {
-            std::string reference = referenceObj["reference"];
-            return getReferenceId(reference);
+        //the part copies are unwrapped in a loop so a deep nesting can not exhaust the stack
+        const json * currentObj = &referenceObj;
+        int copyLevel = 0;
+        for(;;) {
+            JsonSchema::Fields fields = REFERENCE_SCHEMA.validate(*currentObj);
+
+            const json * blockType = fields[REFERENCE_BLOCK_TYPE];
+            if (blockType != NULL && *blockType == PART_COPY_STR) {
+                copyLevel++;
+                TranslationLimits::check(copyLevel, limits.maxReferenceDepth, "reference depth");
+                if (copyLevel > MAX_COPY_LEVEL) {
+                    throw(std::invalid_argument("more than " + std::to_string(MAX_COPY_LEVEL) + " nested part copies"));
+                }
+                currentObj = fields[REFERENCE_REFERENCE];
+            } else {
+                std::string reference = *fields[REFERENCE_REFERENCE];
+                return makeCopyReference(getReferenceId(reference), copyLevel);
+            }
         }
     } catch (std::exception & e) {
         throw(std::invalid_argument("BlocklyFluidicMachineTranslator::processReferenceBlock. exception: " + std::string(e.what())));
@@ -238,63 +905,111 @@ float BlocklyFluidicMachineTranslator::processReferenceBlock(const nlohmann::jso
 }
 
 
-void BlocklyFluidicMachineTranslator::processConnectionMap() throw(std::invalid_argument) {
-    std::unordered_set<int> proccessed;
+void BlocklyFluidicMachineTranslator::processConnectionMap(const std::unordered_set<int> & valves)
+    throw(std::invalid_argument, TranslationInterruptedException)
+{
+    //every id comes from getReferenceId so the processed flags can be a dense vector over the used ids
+    int minId = 0;
+    int maxId = -1;
+    for(const auto & variablePair : variableIdMap) {
+        if (maxId < minId) {
+            minId = variablePair.second;
+            maxId = variablePair.second;
+        } else {
+            minId = std::min(minId, variablePair.second);
+            maxId = std::max(maxId, variablePair.second);
+        }
+    }
+    std::vector<bool> proccessed(maxId - minId + 1, false);
+    auto isProccessed = [&proccessed, minId, maxId](int id) {
+        return id >= minId && id <= maxId && proccessed[id - minId];
+    };
+    auto markProccessed = [&proccessed, minId, maxId](int id) {
+        if (id >= minId && id <= maxId) {
+            proccessed[id - minId] = true;
+        }
+    };
+
+    size_t portsNumber = 0;
+    for(const auto & connectionPair : connectionsMap) {
+        portsNumber += connectionPair.second.size();
+    }
+    edges.clear();
+    edges.reserve(portsNumber / 2 + 1);
 
     //first process the nodes with fixed directions
     for(const auto & directionPair: directedConnectionsMapsIn) {
+        checkInterruption();
         int source = directionPair.first;
-        const std::unordered_set<int> & inPorts = directionPair.second;
-        const std::unordered_set<int> & outPorts = directedConnectionsMapsOut[source];
+        BLOCKLY_TRACE_SPAN(span, "processConnectionMap.directedNode");
+        BLOCKLY_TRACE_ARG(span, "node", source);
+        const PortSet & inPorts = directionPair.second;
+
+        auto outFinded = directedConnectionsMapsOut.find(source);
+        auto connectionsFinded = connectionsMap.find(source);
+        if (outFinded == directedConnectionsMapsOut.end() || connectionsFinded == connectionsMap.end()) {
+            markProccessed(source);
+            continue;
+        }
+        const PortSet & outPorts = outFinded->second;
 
-        const std::unordered_map<float,int> & portsConnections = connectionsMap[source];
-        for(const auto & connectPair : portsConnections) {
+        for(const auto & connectPair : connectionsFinded->second) {
             int target = std::floorf(connectPair.first);
             float prime = connectPair.first - target;
 
             int sourcePort = connectPair.second;
-            int targetPort = connectionsMap[target][source + prime];
 
-            if(inPorts.find(sourcePort) != inPorts.end()) {
-                if (proccessed.find(target) == proccessed.end()) {
-                    model->connectNodes(target, source, targetPort, sourcePort);
+            if(inPorts.contains(sourcePort)) {
+                if (!isProccessed(target)) {
+                    int targetPort = getTargetPort(target, source, prime);
+                    edges.push_back(EdgeRecord(target, source, targetPort, sourcePort));
                 }
-            } else if (outPorts.find(sourcePort) != outPorts.end()) {
-                if (proccessed.find(target) == proccessed.end()) {
-                    model->connectNodes(source, target, sourcePort, targetPort);
+            } else if (outPorts.contains(sourcePort)) {
+                if (!isProccessed(target)) {
+                    int targetPort = getTargetPort(target, source, prime);
+                    edges.push_back(EdgeRecord(source, target, sourcePort, targetPort));
                 }
             } else {
                 throw(std::invalid_argument("BlocklyFluidicMachineTranslator::processConnectionMap. node's " + std::to_string(source) +
                                             "port " + std::to_string(sourcePort) + " is not an in/out port"));
             }
         }
-        connectionsMap.erase(source); //once this node is processed remove it from the map so is not processed again in the next for
-        proccessed.insert(source); //add to processed so edges are not duplicated
+        connectionsMap.erase(connectionsFinded); //once this node is processed remove it from the map so is not processed again in the next for
+        markProccessed(source); //add to processed so edges are not duplicated
     }
 
     //then process valves
-    const std::unordered_set<int> & valves = model->getValvesIdsSet();
     for(int source : valves) {
-        const std::unordered_map<float,int> & portsConnections = connectionsMap[source];
+        checkInterruption();
+        BLOCKLY_TRACE_SPAN(span, "processConnectionMap.valveNode");
+        BLOCKLY_TRACE_ARG(span, "node", source);
+        auto connectionsFinded = connectionsMap.find(source);
+        if (connectionsFinded == connectionsMap.end()) {
+            markProccessed(source);
+            continue;
+        }
 
-        for(const auto & portConnection: portsConnections) {
+        for(const auto & portConnection: connectionsFinded->second) {
             int target = std::floorf(portConnection.first);
             float prime = portConnection.first - target;
 
             int sourcePort = portConnection.second;
-            int targetPort = connectionsMap[target][source + prime];
 
-            if (proccessed.find(target) == proccessed.end()) {
-                model->connectNodes(source, target, sourcePort, targetPort);
+            if (!isProccessed(target)) {
+                int targetPort = getTargetPort(target, source, prime);
+                edges.push_back(EdgeRecord(source, target, sourcePort, targetPort));
             }
         }
-        connectionsMap.erase(source); //once this node is processed remove it from the map so is not processed again in the next for
-        proccessed.insert(source); //add to processed so edges are not duplicated
+        connectionsMap.erase(connectionsFinded); //once this node is processed remove it from the map so is not processed again in the next for
+        markProccessed(source); //add to processed so edges are not duplicated
     }
 
     //then process the reamining nodes that does not have fixed directions
     for(const auto & connectionPair: connectionsMap) {
+        checkInterruption();
         int source = connectionPair.first;
+        BLOCKLY_TRACE_SPAN(span, "processConnectionMap.node");
+        BLOCKLY_TRACE_ARG(span, "node", source);
         const std::unordered_map<float,int> & portsConnections = connectionPair.second;
 
         for(const auto & portConnection: portsConnections) {
@@ -302,23 +1017,228 @@ void BlocklyFluidicMachineTranslator::processConnectionMap() throw(std::invalid_
             float prime = portConnection.first - target;
 
             int sourcePort = portConnection.second;
-            int targetPort = connectionsMap[target][source + prime];
 
-            if (proccessed.find(target) == proccessed.end()) {
-                model->connectNodes(source, target, sourcePort, targetPort);
+            if (!isProccessed(target)) {
+                int targetPort = getTargetPort(target, source, prime);
+                edges.push_back(EdgeRecord(source, target, sourcePort, targetPort));
+            }
+        }
+        markProccessed(source); //add to processed so edges are not duplicated
+    }
+}
+
+int BlocklyFluidicMachineTranslator::getTargetPort(int target, int source, float prime) const throw(std::invalid_argument) {
+    //the key is rebuilt from the copy level instead of adding prime back, which does not always give the same float
+    float sourceReference = makeCopyReference(source, std::lround(prime * 10));
+
+    auto targetFinded = connectionsMap.find(target);
+    if (targetFinded != connectionsMap.end()) {
+        auto portFinded = targetFinded->second.find(sourceReference);
+        if (portFinded != targetFinded->second.end()) {
+            return portFinded->second;
+        }
+    }
+    throw(std::invalid_argument("node " + std::to_string(source) + " is connected to node " + std::to_string(target) +
+                                " but no port of node " + std::to_string(target) + " is connected back"));
+}
+
+void BlocklyFluidicMachineTranslator::addEdges() {
+    for(const EdgeRecord & edge : edges) {
+        model->connectNodes(edge.source, edge.target, edge.sourcePort, edge.targetPort);
+    }
+    edges.clear();
+}
+
+void BlocklyFluidicMachineTranslator::addNodeLabel(
+        int id,
+        const std::string & nodeType,
+        int pinNumber,
+        const JsonSchema::Fields & fields)
+{
+    //the ports are taken from the sets so their order in the file does not matter
+    nodeLabels[id] = makeNodeLabel(nodeType,
+                                   pinNumber,
+                                   directedConnectionsMapsIn.at(id).toVector(),
+                                   directedConnectionsMapsOut.at(id).toVector(),
+                                   *fields[BLOCK_FUNCTIONS],
+                                   fields[BLOCK_EXTRA_FUNCTIONS]);
+}
+
+uint64_t BlocklyFluidicMachineTranslator::makeNodeLabel(
+        const std::string & nodeType,
+        int pinNumber,
+        const std::vector<int> & inPorts,
+        const std::vector<int> & outPorts,
+        const nlohmann::json & functionsObj,
+        const nlohmann::json * extraFunctionsObj)
+{
+    uint64_t label = MachineFingerprint::combine(MachineFingerprint::hashBytes(nodeType), pinNumber);
+    label = MachineFingerprint::combine(label, inPorts.size());
+    for(int port : inPorts) {
+        label = MachineFingerprint::combine(label, port);
+    }
+    label = MachineFingerprint::combine(label, outPorts.size());
+    for(int port : outPorts) {
+        label = MachineFingerprint::combine(label, port);
+    }
+    label = MachineFingerprint::combine(label, hashDescriptor(functionsObj, pinNumber));
+    if (extraFunctionsObj != NULL) {
+        label = MachineFingerprint::combine(label, hashDescriptor(*extraFunctionsObj, pinNumber));
+    }
+    return label;
+}
+
+uint64_t BlocklyFluidicMachineTranslator::hashDescriptor(const nlohmann::json & descriptorObj, int pinNumber) {
+    //hashed by structure so the descriptors differing only in how they are written get the same hash: the keys of a
+    //json object are already sorted, the numbers are compared by value, the truth tables and the functionsList are sets
+    switch (descriptorObj.type()) {
+    case json::value_t::object: {
+        uint64_t hash = MachineFingerprint::combine(1, descriptorObj.size());
+        for(auto it = descriptorObj.begin(); it != descriptorObj.end(); ++it) {
+            uint64_t valueHash = 0;
+            bool hashed = false;
+            if (it.key() == "truthTable") {
+                try {
+                    valueHash = TruthTableCache::hashTruthTable(FunctionsdBlocksTranslator::parseTruthTable(it.value()), pinNumber);
+                    hashed = true;
+                } catch (std::invalid_argument &) {
+                    //a table that can not be parsed is hashed as any other value
+                }
+            } else if (it.key() == "functionsList" && it.value().is_array()) {
+                std::vector<uint64_t> functionHashes;
+                functionHashes.reserve(it.value().size());
+                for(const json & function : it.value()) {
+                    functionHashes.push_back(hashDescriptor(function, pinNumber));
+                }
+                std::sort(functionHashes.begin(), functionHashes.end());
+
+                valueHash = MachineFingerprint::combine(2, functionHashes.size());
+                for(uint64_t functionHash : functionHashes) {
+                    valueHash = MachineFingerprint::combine(valueHash, functionHash);
+                }
+                hashed = true;
+            }
+            if (!hashed) {
+                valueHash = hashDescriptor(it.value(), pinNumber);
+            }
+            hash = MachineFingerprint::combine(MachineFingerprint::combine(hash, MachineFingerprint::hashBytes(it.key())), valueHash);
+        }
+        return hash;
+    }
+    case json::value_t::array: {
+        uint64_t hash = MachineFingerprint::combine(3, descriptorObj.size());
+        for(const json & element : descriptorObj) {
+            hash = MachineFingerprint::combine(hash, hashDescriptor(element, pinNumber));
+        }
+        return hash;
+    }
+    case json::value_t::number_integer:
+    case json::value_t::number_unsigned:
+    case json::value_t::number_float:
+        return hashNumber(descriptorObj);
+    case json::value_t::string:
+        return MachineFingerprint::combine(6, MachineFingerprint::hashBytes(descriptorObj.get_ref<const std::string &>()));
+    case json::value_t::boolean:
+        return MachineFingerprint::combine(7, descriptorObj.get<bool>() ? 1 : 0);
+    default:
+        return MachineFingerprint::combine(8, 0);
+    }
+}
+
+uint64_t BlocklyFluidicMachineTranslator::hashNumber(const nlohmann::json & numberObj) {
+    //an integral float hashes as the integer it holds, so 1 and 1.0 are the same number
+    if (numberObj.is_number_unsigned()) {
+        return MachineFingerprint::combine(4, numberObj.get<uint64_t>());
+    } else if (numberObj.is_number_integer()) {
+        return MachineFingerprint::combine(4, static_cast<uint64_t>(numberObj.get<int64_t>()));
+    }
+
+    double value = numberObj.get<double>();
+    if (std::trunc(value) == value && std::fabs(value) < 9.2e18) {
+        return MachineFingerprint::combine(4, static_cast<uint64_t>(static_cast<int64_t>(value)));
+    }
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return MachineFingerprint::combine(5, bits);
+}
+
+void BlocklyFluidicMachineTranslator::makeFingerprint() {
+    BLOCKLY_TRACE_SPAN(span, "makeFingerprint");
+
+    MachineFingerprintBuilder builder;
+    for(const auto & labelPair : nodeLabels) {
+        builder.addNode(labelPair.first, labelPair.second);
+    }
+    for(const EdgeRecord & edge : edges) {
+        builder.addEdge(edge.source, edge.target, edge.sourcePort, edge.targetPort);
+    }
+    for(const std::unordered_set<int> & twins : twinsVector) {
+        builder.addTwins(twins);
+    }
+    fingerprint = builder.make();
+}
+
+void BlocklyFluidicMachineTranslator::makeFingerprint(const MachineIR & machineIR) throw(std::invalid_argument) {
+    BLOCKLY_TRACE_SPAN(span, "makeFingerprint");
+
+    //the same labels the blocks get, rebuilt from the kinds, port directions and descriptors of the IR
+    static const std::string * const NODE_TYPES[] = {&OPEN_CONTAINER_STR, &CLOSE_CONTAINER_STR, &PUMP_STR, &VALVE_STR};
+
+    MachineFingerprintBuilder builder;
+    for(const MachineIR::Node & node : machineIR.getNodes()) {
+        if (node.kind > MachineIR::valve_node) {
+            throw(std::invalid_argument("unknow node kind " + std::to_string(node.kind) + " of node " + std::to_string(node.id)));
+        }
+
+        std::vector<int> inPorts;
+        std::vector<int> outPorts;
+        for(uint32_t pin = 0; pin < node.pins; pin++) {
+            MachineIR::PortDirection direction = machineIR.getPortDirection(node, pin);
+            if (direction == MachineIR::in_port) {
+                inPorts.push_back(pin);
+            } else if (direction == MachineIR::out_port) {
+                outPorts.push_back(pin);
             }
         }
-        proccessed.insert(source); //add to processed so edges are not duplicated
+
+        json functionsObj = machineIR.getDescriptorJson(node.functions);
+        json extraFunctionsObj;
+        if (node.extraFunctions != MachineIR::NO_DESCRIPTOR) {
+            extraFunctionsObj = machineIR.getDescriptorJson(node.extraFunctions);
+        }
+        builder.addNode(node.id, makeNodeLabel(*NODE_TYPES[node.kind],
+                                               node.pins,
+                                               inPorts,
+                                               outPorts,
+                                               functionsObj,
+                                               node.extraFunctions != MachineIR::NO_DESCRIPTOR ? &extraFunctionsObj : NULL));
+    }
+    for(const MachineIR::Edge & edge : machineIR.getEdges()) {
+        builder.addEdge(edge.source, edge.target, edge.sourcePort, edge.targetPort);
     }
+
+    const std::vector<uint32_t> & twinOffsets = machineIR.getTwinOffsets();
+    const std::vector<int> & twinMembers = machineIR.getTwinMembers();
+    for(size_t group = 0; group < machineIR.getTwinGroupsNumber(); group++) {
+        builder.addTwins(std::unordered_set<int>(twinMembers.begin() + twinOffsets[group],
+                                                 twinMembers.begin() + twinOffsets[group + 1]));
+    }
+    fingerprint = builder.make();
 }
 
 void BlocklyFluidicMachineTranslator::processTwins() {
+    BLOCKLY_TRACE_SPAN(span, "processTwins");
+    BLOCKLY_TRACE_ARG(span, "groups", twinsVector.size());
     for(const std::unordered_set<int> & twins: twinsVector) {
         model->setValvesAsTwins(twins);
     }
 }
 
 void BlocklyFluidicMachineTranslator::addNewConnection(int source, int sourcePort, float target) {
+    //every edge is normally declared by the ports of both of its ends
+    portConnections++;
+    TranslationLimits::check(portConnections, limits.maxEdges * 2, "port connections");
+
     auto finded = connectionsMap.find(source);
     if (finded != connectionsMap.end()) {
         std::unordered_map<float,int> & portMap = finded->second;
@@ -332,8 +1252,8 @@ void BlocklyFluidicMachineTranslator::addNewConnection(int source, int sourcePor
 
 void BlocklyFluidicMachineTranslator::addDirectionPorts(
         int id,
-        const std::unordered_set<int> & inPorts,
-        const std::unordered_set<int> & outPorts)
+        const PortSet & inPorts,
+        const PortSet & outPorts)
     throw(std::invalid_argument)
 {
     if (directedConnectionsMapsIn.find(id) == directedConnectionsMapsIn.end() &&
@@ -377,3 +1297,169 @@ int BlocklyFluidicMachineTranslator::getReferenceId(const std::string & referenc
 
 
 
+
+
+void BlocklyFluidicMachineTranslator::checkInterruption() const throw(TranslationInterruptedException) {
+    if (monitor) {
+        monitor->checkInterruption();
+    }
+}
+
+void BlocklyFluidicMachineTranslator::checkPluginParams(const nlohmann::json & functionsObj) const throw(std::invalid_argument) {
+    //the plugin descriptors are either the functions object itself or the entries of its functionsList
+    std::vector<const json *> descriptors = {&functionsObj};
+    auto functionsList = functionsObj.find("functionsList");
+    if (functionsList != functionsObj.end() && functionsList->is_array()) {
+        for(auto it = functionsList->begin(); it != functionsList->end(); ++it) {
+            descriptors.push_back(&(*it));
+        }
+    }
+
+    for(const json * descriptor : descriptors) {
+        if (descriptor->is_object()) {
+            auto paramsNumber = descriptor->find("paramsNumber");
+            if (paramsNumber != descriptor->end() && paramsNumber->is_number()) {
+                TranslationLimits::check(TranslationLimits::toValue(*paramsNumber), limits.maxParamsPerPlugin, "paramsNumber");
+            }
+        }
+    }
+}
+
+JsonLimitsScanner::ValueCheck BlocklyFluidicMachineTranslator::makeLimitsCheck(const std::vector<std::string> & blocksKeys) const {
+    //the blocks are the elements of the array at blocksKeys, or the whole document when there are no keys
+    TranslationLimits limits = this->limits;
+    size_t blockDepth = (blocksKeys.empty() ? 0 : blocksKeys.size() + 1);
+    size_t blocks = 0;
+    return [limits, blocksKeys, blockDepth, blocks](const std::vector<std::string> & keys, const double * number) mutable {
+        if (keys.size() < blockDepth || !std::equal(blocksKeys.begin(), blocksKeys.end(), keys.begin())) {
+            return;
+        }
+
+        size_t fields = keys.size() - blockDepth;
+        if (number == NULL) {
+            if (blockDepth > 0 && fields == 0) {
+                blocks++;
+                TranslationLimits::check(blocks, limits.maxBlocks, "blocks");
+            }
+        } else if (fields == 1 && keys[blockDepth] == "number_pins") {
+            TranslationLimits::check(TranslationLimits::toValue(*number), limits.maxPinsPerNode, "number_pins");
+        } else if (fields == 1 && keys[blockDepth] == "number_twins") {
+            TranslationLimits::check(TranslationLimits::toValue(*number), limits.maxBlocks, "number_twins");
+        } else if ((fields == 2 || (fields == 4 && keys[blockDepth + 1] == "functionsList")) &&
+                   (keys[blockDepth] == "functions" || keys[blockDepth] == "extra_functions") &&
+                   keys.back() == "paramsNumber")
+        {
+            //the same descriptors checkPluginParams looks at
+            TranslationLimits::check(TranslationLimits::toValue(*number), limits.maxParamsPerPlugin, "paramsNumber");
+        }
+    };
+}
+
+void BlocklyFluidicMachineTranslator::addEstimatedMemory(size_t bytes) throw(std::invalid_argument) {
+    estimatedMemory += bytes;
+    TranslationLimits::check(estimatedMemory, limits.maxEstimatedMemory, "estimated memory");
+}
+
+void BlocklyFluidicMachineTranslator::addPendingNode(int id, NodeMaker maker) {
+    pendingNodes.push_back(std::make_pair(id, maker));
+}
+
+void BlocklyFluidicMachineTranslator::addPendingNodes() {
+    for(const auto & pendingPair : pendingNodes) {
+        pendingPair.second(pendingPair.first, *model, deferredFunctions.get());
+    }
+    pendingNodes.clear();
+}
+
+void BlocklyFluidicMachineTranslator::renumberNodes() {
+    if (nodeOrdering == NodeReordering::reference_order) {
+        return;
+    }
+
+    std::vector<int> ids;
+    ids.reserve(variableIdMap.size());
+    for(const auto & variablePair : variableIdMap) {
+        ids.push_back(variablePair.second);
+    }
+
+    NodeReordering::AdjacencyMap adjacency;
+    for(const auto & connectionPair : connectionsMap) {
+        std::unordered_set<int> & neighbours = adjacency[connectionPair.first];
+        for(const auto & portConnection : connectionPair.second) {
+            neighbours.insert(std::floor(portConnection.first));
+        }
+    }
+
+    std::unordered_map<int,int> permutation = NodeReordering::makePermutation(nodeOrdering, ids, adjacency);
+    auto newId = [&permutation](int oldId) {
+        auto finded = permutation.find(oldId);
+        return (finded != permutation.end() ? finded->second : oldId);
+    };
+
+    for(auto & variablePair : variableIdMap) {
+        variablePair.second = newId(variablePair.second);
+    }
+
+    for(auto & pendingPair : pendingNodes) {
+        pendingPair.first = newId(pendingPair.first);
+    }
+
+    std::unordered_map<int, uint64_t> renumberedLabels;
+    renumberedLabels.reserve(nodeLabels.size());
+    for(const auto & labelPair : nodeLabels) {
+        renumberedLabels.insert(std::make_pair(newId(labelPair.first), labelPair.second));
+    }
+    nodeLabels.swap(renumberedLabels);
+
+    for(MachineIR::Node & node : irNodes) {
+        node.id = newId(node.id);
+    }
+
+    std::unordered_set<int> renumberedValves;
+    renumberedValves.reserve(valveIds.size());
+    for(int valveId : valveIds) {
+        renumberedValves.insert(newId(valveId));
+    }
+    valveIds.swap(renumberedValves);
+
+    std::unordered_map<int,std::unordered_map<float,int>> renumberedConnections;
+    renumberedConnections.reserve(connectionsMap.size());
+    for(const auto & connectionPair : connectionsMap) {
+        std::unordered_map<float,int> & portMap = renumberedConnections[newId(connectionPair.first)];
+        for(const auto & portConnection : connectionPair.second) {
+            int target = std::floor(portConnection.first);
+            int copyLevel = std::lround((portConnection.first - target) * 10);
+            portMap.insert(std::make_pair(makeCopyReference(newId(target), copyLevel), portConnection.second));
+        }
+    }
+    connectionsMap.swap(renumberedConnections);
+
+    std::unordered_map<int,PortSet> renumberedIn;
+    for(const auto & directionPair : directedConnectionsMapsIn) {
+        renumberedIn.insert(std::make_pair(newId(directionPair.first), directionPair.second));
+    }
+    directedConnectionsMapsIn.swap(renumberedIn);
+
+    std::unordered_map<int,PortSet> renumberedOut;
+    for(const auto & directionPair : directedConnectionsMapsOut) {
+        renumberedOut.insert(std::make_pair(newId(directionPair.first), directionPair.second));
+    }
+    directedConnectionsMapsOut.swap(renumberedOut);
+
+    for(std::unordered_set<int> & twins : twinsVector) {
+        std::unordered_set<int> renumberedTwins;
+        for(int twin : twins) {
+            renumberedTwins.insert(newId(twin));
+        }
+        twins.swap(renumberedTwins);
+    }
+}
+
+float BlocklyFluidicMachineTranslator::makeCopyReference(int id, int copyLevel) {
+    //the same arithmetic is used everywhere a copy reference is built so the keys of both ends of a connection match
+    float reference = id;
+    for(int i = 0; i < copyLevel; i++) {
+        reference = 0.1 + reference;
+    }
+    return reference;
+}
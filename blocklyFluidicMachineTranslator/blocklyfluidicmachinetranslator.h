@@ -1,7 +1,12 @@
 #ifndef BLOCKLYFLUIDICMACHINETRANSLATOR_H
 #define BLOCKLYFLUIDICMACHINETRANSLATOR_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <memory>
 #include <stdexcept>
 #include <tuple>
@@ -27,49 +32,238 @@
 #include <utils/AutoEnumerate.h>
 #include <utils/utilsjson.h>
 
+#include "blocklyFluidicMachineTranslator/blocks/deferredfunctionsstore.h"
 #include "blocklyFluidicMachineTranslator/blocks/functionsdblockstranslator.h"
+#include "blocklyFluidicMachineTranslator/graph/componentpartition.h"
+#include "blocklyFluidicMachineTranslator/graph/machinefingerprintbuilder.h"
+#include "blocklyFluidicMachineTranslator/graph/nodereordering.h"
+#include "blocklyFluidicMachineTranslator/graph/portset.h"
+#include "blocklyFluidicMachineTranslator/io/decompressingstreambuf.h"
+#include "blocklyFluidicMachineTranslator/ir/machinegraphbackend.h"
+#include "blocklyFluidicMachineTranslator/ir/machineir.h"
+#include "blocklyFluidicMachineTranslator/json/indexedfieldsextractor.h"
+#include "blocklyFluidicMachineTranslator/json/jsondocumentparser.h"
+#include "blocklyFluidicMachineTranslator/json/jsonschema.h"
+#include "blocklyFluidicMachineTranslator/profiling/phasecounters.h"
+#include "blocklyFluidicMachineTranslator/translationcontext.h"
+#include "blocklyFluidicMachineTranslator/translationmonitor.h"
+#include "blocklyFluidicMachineTranslator/tracing/tracer.h"
 #include "blocklyfluidicmachinetranslator_global.h"
 
+// an instance holds the scratch state of the translation in progress, so it must not be used by two threads at the same
+// time; it is reset at the start of every translation so the same instance can translate again afterwards. Concurrent
+// translations use one translator each, all of them can share the same TranslationContext.
 class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT BlocklyFluidicMachineTranslator
 {
     static const std::string OPEN_CONTAINER_STR;
     static const std::string CLOSE_CONTAINER_STR;
     static const std::string PUMP_STR;
     static const std::string VALVE_STR;
+    static const std::string PART_COPY_STR;
+
+    static const size_t NODE_MEMORY_ESTIMATE;
+    static const size_t PORT_MEMORY_ESTIMATE;
+    //the copies are encoded as tenths added to the id, one more level would reach the next id
+    static const int MAX_COPY_LEVEL;
 
 public:
 
     typedef std::tuple<std::shared_ptr<FluidicMachineModel>, std::shared_ptr<FluidicModelMapping>> ModelMappingTuple;
 
     BlocklyFluidicMachineTranslator(const std::string & path, std::shared_ptr<PluginAbstractFactory> factory);
+    BlocklyFluidicMachineTranslator(const std::string & path, std::shared_ptr<const TranslationContext> context);
     virtual ~BlocklyFluidicMachineTranslator();
 
+    // the input files can also be gzip or zstd compressed, see DecompressingStreamBuf
     ModelMappingTuple translateFile();
+    ModelMappingTuple translateFile(std::shared_ptr<TranslationMonitor> monitor);
+
+    // also return the MachineFingerprint of the translated machine, the same one getFingerprint() gives afterwards. It is
+    // computed for this translation even if setFingerprintEnabled was not called
+    ModelMappingTuple translateFile(MachineFingerprint & fingerprint);
+    ModelMappingTuple translateFile(std::shared_ptr<TranslationMonitor> monitor, MachineFingerprint & fingerprint);
+
+    // same as translateFile but the nodes that are not joined by any connection or valve twin group are split in one
+    // model and mapping per connected component, ordered by their lowest node id. All of them share the ids of
+    // getVariableIdMap().
+    std::vector<ModelMappingTuple> translateFileComponents();
+    std::vector<ModelMappingTuple> translateFileComponents(std::shared_ptr<TranslationMonitor> monitor);
+
+    // the file is translated only up to the flat MachineIR, see ir/machineir.h. translateIR lowers an IR, translated
+    // here or read from a MachineIRImage, to the model and mapping; the ids of getVariableIdMap() are the ones of the IR
+    // and getFingerprint() is computed from the IR, equal to the one of the file it was translated from. The functions
+    // of an IR are only built, and their descriptors checked, when it is lowered.
+    std::shared_ptr<MachineIR> translateFileToIR();
+    std::shared_ptr<MachineIR> translateFileToIR(std::shared_ptr<TranslationMonitor> monitor);
+    ModelMappingTuple translateIR(const MachineIR & machineIR);
+
+    // model and mapping of an already built graph, with the stack leased from stackPool when there is one
+    static ModelMappingTuple buildModelMapping(std::shared_ptr<MachineGraph> graph,
+                                               const MachineIR::Header & header,
+                                               std::shared_ptr<TranslationStackPool> stackPool) throw(std::invalid_argument);
+
+    // the translator must outlive the returned future and must not be used by anyone else until it is ready
+    std::future<ModelMappingTuple> translateFileAsync(std::shared_ptr<TranslationMonitor> monitor);
+
+    // line delimited variant of the format: the first line holds the header fields ("default_rate", units, precissions
+    // and an optional "number_blocks") and every following line holds one configuration block, so the document never
+    // has to be in memory as a whole and can be split by lines.
+    ModelMappingTuple translateLineDelimitedFile();
+    ModelMappingTuple translateLineDelimitedFile(std::shared_ptr<TranslationMonitor> monitor);
+
+    std::shared_ptr<const TranslationContext> getContext() const {
+        return context;
+    }
 
     const std::unordered_map<std::string, int> & getVariableIdMap() const {
         return variableIdMap;
     }
+
+    // the ids are renumbered following the traversal of the connections graph before the nodes are added to the
+    // MachineGraph, so connected nodes get close ids. The default is taken from the context, reference_order keeps
+    // the order of appearance.
+    void setNodeOrdering(NodeReordering::Ordering ordering) {
+        nodeOrdering = ordering;
+    }
+    NodeReordering::Ordering getNodeOrdering() const {
+        return nodeOrdering;
+    }
+
+    // the PrologTranslationStack of the created models is leased from this pool, the one of the context by default.
+    // Without a pool every model builds its own stack.
+    void setStackPool(std::shared_ptr<TranslationStackPool> stackPool) {
+        this->stackPool = stackPool;
+    }
+    std::shared_ptr<TranslationStackPool> getStackPool() const {
+        return stackPool;
+    }
+
+    // budgets of the translations, the ones of the context by default
+    void setLimits(const TranslationLimits & limits) {
+        this->limits = limits;
+    }
+    const TranslationLimits & getLimits() const {
+        return limits;
+    }
+
+    // when enabled every translation reads the hardware counters of its phases, available afterwards through
+    // getPhaseCounters() until the next translation starts
+    void setHardwareCountersEnabled(bool enabled) {
+        hardwareCountersEnabled = enabled;
+    }
+    bool isHardwareCountersEnabled() const {
+        return hardwareCountersEnabled;
+    }
+    std::shared_ptr<const PhaseCounters> getPhaseCounters() const {
+        return phaseCounters;
+    }
+
+    // when enabled the extra_functions of the containers are not translated, they are kept in the DeferredFunctionsStore
+    // returned by getDeferredFunctions() and built on demand. Every translation starts a new store.
+    void setLazyExtraFunctions(bool lazy) {
+        lazyExtraFunctions = lazy;
+    }
+    bool isLazyExtraFunctions() const {
+        return lazyExtraFunctions;
+    }
+    std::shared_ptr<DeferredFunctionsStore> getDeferredFunctions() const {
+        return deferredFunctions;
+    }
+
+    // fingerprint of the last machine translated. It covers the type, pins, port directions and functions of every
+    // node, the connections and the valve twin groups; the references, the order of the blocks and any other field of
+    // the blocks are left out, so cosmetic changes of the file keep the fingerprint. It is only computed while enabled,
+    // otherwise getFingerprint() is empty.
+    void setFingerprintEnabled(bool enabled) {
+        fingerprintEnabled = enabled;
+    }
+    bool isFingerprintEnabled() const {
+        return fingerprintEnabled;
+    }
+    const MachineFingerprint & getFingerprint() const {
+        return fingerprint;
+    }
 protected:
+    //the store is the DeferredFunctionsStore of the translation building the node, used by the lazy containers
+    typedef std::function<void(int nodeId, MachineGraph & graph, DeferredFunctionsStore * store)> NodeMaker;
+
+    static const JsonSchema HEADER_SCHEMA;
+    static const JsonSchema BLOCK_SCHEMA;
+    static const JsonSchema REFERENCE_SCHEMA;
+
+    struct EdgeRecord {
+        int source;
+        int target;
+        int sourcePort;
+        int targetPort;
+
+        EdgeRecord(int source, int target, int sourcePort, int targetPort) :
+            source(source), target(target), sourcePort(sourcePort), targetPort(targetPort)
+        {}
+    };
+
     std::string path;
+    std::shared_ptr<const TranslationContext> context;
+    NodeReordering::Ordering nodeOrdering;
+    std::shared_ptr<TranslationStackPool> stackPool;
+    TranslationLimits limits;
+    bool hardwareCountersEnabled;
+    bool lazyExtraFunctions;
+    bool fingerprintEnabled;
 
     std::shared_ptr<MachineGraph> model;
-    std::shared_ptr<PluginAbstractFactory> factory;
+    std::shared_ptr<TranslationMonitor> monitor;
 
     AutoEnumerate serie;
     std::unordered_map<std::string, int> variableIdMap;
 
     std::unordered_map<int,std::unordered_map<float,int>> connectionsMap;
-    std::unordered_map<int,std::unordered_set<int>> directedConnectionsMapsIn;
-    std::unordered_map<int,std::unordered_set<int>> directedConnectionsMapsOut;
+    std::unordered_map<int,PortSet> directedConnectionsMapsIn;
+    std::unordered_map<int,PortSet> directedConnectionsMapsOut;
 
     std::vector<std::unordered_set<int>> twinsVector;
 
+    std::vector<std::pair<int, NodeMaker>> pendingNodes;
+    TruthTableCache truthTableCache;
+    PluginFunctionCache pluginFunctionCache;
+    std::vector<EdgeRecord> edges;
+
+    size_t portConnections;
+    size_t estimatedMemory;
+
+    std::shared_ptr<PhaseCounters> phaseCounters;
+    std::shared_ptr<DeferredFunctionsStore> deferredFunctions;
+
+    std::unordered_map<int, uint64_t> nodeLabels;
+    MachineFingerprint fingerprint;
+
+    //recorded in every mode, so the connections can be processed before any node is built
+    std::unordered_set<int> valveIds;
+
+    std::shared_ptr<MachineIR> ir;
+    std::vector<MachineIR::Node> irNodes;
+
+    void resetState();
+    JsonSchema::Fields readFile(nlohmann::json & js) throw(std::invalid_argument, TranslationInterruptedException);
+    ModelMappingTuple makeModelMapping(const JsonSchema::Fields & headerFields)
+        throw(std::invalid_argument, TranslationInterruptedException);
+    std::vector<ModelMappingTuple> makeComponentMappings(const JsonSchema::Fields & headerFields)
+        throw(std::invalid_argument, TranslationInterruptedException);
+    std::shared_ptr<MachineIR> makeIR(const JsonSchema::Fields & headerFields)
+        throw(std::invalid_argument, TranslationInterruptedException);
+    ModelMappingTuple buildModelMapping(std::shared_ptr<MachineGraph> graph, const MachineIR::Header & header)
+        throw(std::invalid_argument);
+    static MachineIR::Header makeHeader(const JsonSchema::Fields & headerFields) throw(std::invalid_argument);
+
     void processConfigurationBlock(const nlohmann::json & blockObj) throw(std::invalid_argument);
-    void processDirectionsPorts(const std::string & id, const nlohmann::json & blockObj) throw(std::invalid_argument);
+    void processDirectionsPorts(const std::string & id,
+                                int pinNumber,
+                                const nlohmann::json & inPortsList,
+                                const nlohmann::json & outPortsList) throw(std::invalid_argument);
 
     void processPump(const std::string & id, int pinNumber, const nlohmann::json & functionsObj);
     void processValve(const std::string & id, int pinNumber, const nlohmann::json & functionsObj);
-    void processValveTwins(const std::string & id, const nlohmann::json & functionsObj);
+    void processValveTwins(const std::string & id, const nlohmann::json * numberTwinsObj, const nlohmann::json & blockObj);
 
     void processOpenContainer(const std::string & id,
                               int pinNumber,
@@ -82,13 +276,42 @@ protected:
 
     float processReferenceBlock(const nlohmann::json & referenceObj) throw(std::invalid_argument);
 
-    void processConnectionMap() throw(std::invalid_argument);
+    void processConnectionMap(const std::unordered_set<int> & valves)
+        throw(std::invalid_argument, TranslationInterruptedException);
+    int getTargetPort(int target, int source, float prime) const throw(std::invalid_argument);
+    void addEdges();
     void processTwins();
 
+    void addNodeLabel(int id, const std::string & nodeType, int pinNumber, const JsonSchema::Fields & fields);
+    static uint64_t makeNodeLabel(const std::string & nodeType,
+                                  int pinNumber,
+                                  const std::vector<int> & inPorts,
+                                  const std::vector<int> & outPorts,
+                                  const nlohmann::json & functionsObj,
+                                  const nlohmann::json * extraFunctionsObj);
+    static uint64_t hashDescriptor(const nlohmann::json & descriptorObj, int pinNumber);
+    static uint64_t hashNumber(const nlohmann::json & numberObj);
+    void makeFingerprint();
+    void makeFingerprint(const MachineIR & machineIR) throw(std::invalid_argument);
+
+    void addIRNode(int id, const std::string & nodeType, int pinNumber, const JsonSchema::Fields & fields);
+
     void addNewConnection(int source, int sourcePort, float target);
-    void addDirectionPorts(int id, const std::unordered_set<int> & inPorts, const std::unordered_set<int> & outPorts) throw(std::invalid_argument);
+    void addDirectionPorts(int id, const PortSet & inPorts, const PortSet & outPorts) throw(std::invalid_argument);
 
     int getReferenceId(const std::string & reference);
+
+    void addPendingNode(int id, NodeMaker maker);
+    void addPendingNodes();
+
+    void renumberNodes();
+    static float makeCopyReference(int id, int copyLevel);
+
+    void checkInterruption() const throw(TranslationInterruptedException);
+    void checkPluginParams(const nlohmann::json & functionsObj) const throw(std::invalid_argument);
+    // checks number_pins, number_twins, paramsNumber and the number of blocks while the document is parsed
+    JsonLimitsScanner::ValueCheck makeLimitsCheck(const std::vector<std::string> & blocksKeys) const;
+    void addEstimatedMemory(size_t bytes) throw(std::invalid_argument);
 };
 
 #endif // BLOCKLYFLUIDICMACHINETRANSLATOR_H
@@ -0,0 +1,104 @@
+#include "deferredfunctionsstore.h"
+
+DeferredFunctionsStore::DeferredFunctionsStore(std::shared_ptr<PluginAbstractFactory> factory) {
+    this->factory = factory;
+}
+
+DeferredFunctionsStore::~DeferredFunctionsStore() {
+
+}
+
+DeferredFunctionsStore::Descriptor DeferredFunctionsStore::compact(const nlohmann::json & extraFunctionsObj) {
+    return nlohmann::json::to_cbor(extraFunctionsObj);
+}
+
+void DeferredFunctionsStore::defer(int nodeId, std::shared_ptr<ContainerNode> node, const Descriptor & descriptor) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Entry & entry = entries[nodeId];
+    entry.node = node;
+    entry.descriptor = descriptor;
+    entry.materialized = false;
+    entry.functions.clear();
+}
+
+std::vector<std::shared_ptr<Function>> DeferredFunctionsStore::getFunctions(int nodeId) throw(std::invalid_argument) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto finded = entries.find(nodeId);
+    if (finded == entries.end()) {
+        return std::vector<std::shared_ptr<Function>>();
+    }
+    materialize(nodeId, finded->second);
+    return finded->second.functions;
+}
+
+void DeferredFunctionsStore::materialize(int nodeId) throw(std::invalid_argument) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto finded = entries.find(nodeId);
+    if (finded != entries.end()) {
+        materialize(nodeId, finded->second);
+    }
+}
+
+void DeferredFunctionsStore::materialize() throw(std::invalid_argument) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for(auto & entryPair : entries) {
+        materialize(entryPair.first, entryPair.second);
+    }
+}
+
+bool DeferredFunctionsStore::isMaterialized(int nodeId) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto finded = entries.find(nodeId);
+    return (finded == entries.end() || finded->second.materialized);
+}
+
+size_t DeferredFunctionsStore::getPendingNodes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    size_t pending = 0;
+    for(const auto & entryPair : entries) {
+        if (!entryPair.second.materialized) {
+            pending++;
+        }
+    }
+    return pending;
+}
+
+size_t DeferredFunctionsStore::getDescriptorsBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    size_t bytes = 0;
+    for(const auto & entryPair : entries) {
+        bytes += entryPair.second.descriptor.size();
+    }
+    return bytes;
+}
+
+void DeferredFunctionsStore::materialize(int nodeId, Entry & entry) throw(std::invalid_argument) {
+    if (entry.materialized) {
+        return;
+    }
+
+    try {
+        nlohmann::json extraFunctionsObj = nlohmann::json::from_cbor(entry.descriptor);
+        entry.functions = FunctionsdBlocksTranslator::processFunctions(extraFunctionsObj, factory, functionCache);
+
+        std::shared_ptr<ContainerNode> node = entry.node.lock();
+        if (node) {
+            for(auto func : entry.functions) {
+                node->addOperation(func);
+            }
+        }
+
+        entry.materialized = true;
+        Descriptor().swap(entry.descriptor);
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("DeferredFunctionsStore::materialize. node " + std::to_string(nodeId) +
+                                    ", exception ocurred " + std::string(e.what())));
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef DEFERREDFUNCTIONSSTORE_H
+#define DEFERREDFUNCTIONSSTORE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <json.hpp>
+
+#include <commonmodel/functions/function.h>
+
+#include <fluidicmachinemodel/fluidicnode/containernode.h>
+
+#include "blocklyFluidicMachineTranslator/blocks/functionsdblockstranslator.h"
+#include "blocklyFluidicMachineTranslator/blocks/pluginfunctioncache.h"
+
+// extra functions of the containers kept as compact (CBOR) descriptors instead of Function objects. The functions of a
+// node are built and added to its ContainerNode the first time they are requested through getFunctions() or when
+// materialize() is called, so loads that only need the topology never pay for them. Errors in the descriptors are
+// reported at that moment. Thread safe.
+class DeferredFunctionsStore
+{
+public:
+    typedef std::vector<uint8_t> Descriptor;
+
+    DeferredFunctionsStore(std::shared_ptr<PluginAbstractFactory> factory);
+    virtual ~DeferredFunctionsStore();
+
+    static Descriptor compact(const nlohmann::json & extraFunctionsObj);
+
+    void defer(int nodeId, std::shared_ptr<ContainerNode> node, const Descriptor & descriptor);
+
+    std::vector<std::shared_ptr<Function>> getFunctions(int nodeId) throw(std::invalid_argument);
+    void materialize(int nodeId) throw(std::invalid_argument);
+    void materialize() throw(std::invalid_argument);
+
+    bool isMaterialized(int nodeId) const;
+    size_t getPendingNodes() const;
+    size_t getDescriptorsBytes() const;
+
+protected:
+    struct Entry {
+        std::weak_ptr<ContainerNode> node;
+        Descriptor descriptor;
+        bool materialized;
+        std::vector<std::shared_ptr<Function>> functions;
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<int, Entry> entries;
+
+    std::shared_ptr<PluginAbstractFactory> factory;
+    PluginFunctionCache functionCache;
+
+    void materialize(int nodeId, Entry & entry) throw(std::invalid_argument);
+};
+
+#endif // DEFERREDFUNCTIONSSTORE_H
@@ -14,8 +14,64 @@ const std::string FunctionsdBlocksTranslator::STIR_STR = "Stirer";
 const std::string FunctionsdBlocksTranslator::SHAKE_STR = "Shaker";
 const std::string FunctionsdBlocksTranslator::CENTRIFUGATE_STR = "Centrifugator";
 const std::string FunctionsdBlocksTranslator::FUNCTION_LIST_STR = "functions_list";
+const std::string FunctionsdBlocksTranslator::PUMP_FUNCTION_KIND = "PUMP";
+const std::string FunctionsdBlocksTranslator::VALVE_FUNCTION_KIND = "VALVE";
+
+namespace {
+enum FunctionFields { FUNCTION_TYPE, FUNCTION_LIST };
+enum PluginFields { PLUGIN_BLOCK_TYPE, PLUGIN_TYPE, PLUGIN_PARAMS_NUMBER };
+enum ValveFields { VALVE_TRUTH_TABLE };
+enum VolumeFields { MIN_VOLUME, MIN_VOLUME_UNITS, MAX_VOLUME, MAX_VOLUME_UNITS };
+enum TruthTableRowFields { ROW_POSITION, ROW_CONNECTED_PINS };
+enum RangeFields { MIN_RANGE, MIN_RANGE_UNITS, MAX_RANGE, MAX_RANGE_UNITS };
+enum ElectrophoresisRangeFields { E_MIN_RANGE, E_MIN_FIELD_UNITS, E_MIN_LENGTH_UNITS, E_MAX_RANGE, E_MAX_FIELD_UNITS, E_MAX_LENGTH_UNITS };
+enum LightRangeFields { MIN_WAVELENGTH, MIN_WAVELENGTH_UNITS, MAX_WAVELENGTH, MAX_WAVELENGTH_UNITS,
+                        MIN_INTENSITY, MIN_INTENSITY_UNITS, MAX_INTENSITY, MAX_INTENSITY_UNITS };
+enum FluorescenceRangeFields { MIN_EMISSION, MIN_EMISSION_UNITS, MAX_EMISSION, MAX_EMISSION_UNITS,
+                               MIN_EXCITATION, MIN_EXCITATION_UNITS, MAX_EXCITATION, MAX_EXCITATION_UNITS };
+enum PumpRangeFields { P_MIN_RANGE, P_MIN_VOLUME_UNITS, P_MIN_TIME_UNITS, P_MAX_RANGE, P_MAX_VOLUME_UNITS, P_MAX_TIME_UNITS, P_REVERSIBLE };
+}
 
-const FunctionsdBlocksTranslator::FunctionsMap FunctionsdBlocksTranslator::functionsTypeMap(makeFunctionsMap());
+const JsonSchema FunctionsdBlocksTranslator::FUNCTION_SCHEMA({"type"}, {"functionsList"});
+const JsonSchema FunctionsdBlocksTranslator::PLUGIN_SCHEMA({"block_type", "type", "paramsNumber"});
+const JsonSchema FunctionsdBlocksTranslator::VALVE_SCHEMA({"truthTable"});
+const JsonSchema FunctionsdBlocksTranslator::GLASSWARE_SCHEMA({"minVolume", "minVolumeUnits", "maxVolume", "maxVolumeUnits"});
+const JsonSchema FunctionsdBlocksTranslator::MIN_VOLUME_SCHEMA({"minVolume", "minVolumeUnits"});
+const JsonSchema FunctionsdBlocksTranslator::TRUTH_TABLE_ROW_SCHEMA({"position", "connected_pins"});
+const JsonSchema FunctionsdBlocksTranslator::RANGE_SCHEMA({"minRange", "minRangeUnits", "maxRange", "maxRangeUnits"});
+const JsonSchema FunctionsdBlocksTranslator::ELECTROPHORESIS_RANGE_SCHEMA({
+                                                                             "minRange",
+                                                                             "minRageEFieldUnits",
+                                                                             "minRageLengthUnits",
+                                                                             "maxRange",
+                                                                             "maxRageEFieldUnits",
+                                                                             "maxRageLengthUnits"});
+const JsonSchema FunctionsdBlocksTranslator::LIGHT_RANGE_SCHEMA({
+                                                                   "minWavelength",
+                                                                   "minWavelengthUnits",
+                                                                   "maxWavelength",
+                                                                   "maxWavelengthUnits",
+                                                                   "minIntensity",
+                                                                   "minIntensityUnits",
+                                                                   "maxIntensity",
+                                                                   "maxIntensityUnits"});
+const JsonSchema FunctionsdBlocksTranslator::FLUORESCENCE_RANGE_SCHEMA({
+                                                                          "minEmission",
+                                                                          "minEmissionUnits",
+                                                                          "maxEmission",
+                                                                          "maxEmissionUnits",
+                                                                          "minExcitation",
+                                                                          "minExcitationUnits",
+                                                                          "maxExcitation",
+                                                                          "maxExcitationUnits"});
+const JsonSchema FunctionsdBlocksTranslator::PUMP_RANGE_SCHEMA({
+                                                                  "minRange",
+                                                                  "minRangeVolumeUnits",
+                                                                  "minRangeTimeUnits",
+                                                                  "maxRange",
+                                                                  "maxRangeVolumeUnits",
+                                                                  "maxRangeTimeUnits",
+                                                                  "reversible"});
 
 FunctionsdBlocksTranslator::FunctionsMap FunctionsdBlocksTranslator::makeFunctionsMap() {
     FunctionsMap functions;
@@ -35,26 +91,58 @@ FunctionsdBlocksTranslator::FunctionsMap FunctionsdBlocksTranslator::makeFunctio
     return functions;
 }
 
-std::vector<std::shared_ptr<Function>> FunctionsdBlocksTranslator::processFunctions(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+const FunctionsdBlocksTranslator::FunctionsMap & FunctionsdBlocksTranslator::getFunctionsTypeMap() {
+    //built on first use (thread safe since c++11) instead of at static initialization, where it could run before the
+    //type strings of this unit are initialized; afterwards it is only read
+    static const FunctionsMap functionsTypeMap(makeFunctionsMap());
+    return functionsTypeMap;
+}
+
+std::vector<std::shared_ptr<Function>> FunctionsdBlocksTranslator::processFunctions(
+        const nlohmann::json & functionObj,
+        std::shared_ptr<PluginAbstractFactory> factory)
+    throw(std::invalid_argument)
+{
+    return processFunctions(functionObj, factory, NULL);
+}
+
+std::vector<std::shared_ptr<Function>> FunctionsdBlocksTranslator::processFunctions(
+        const nlohmann::json & functionObj,
+        std::shared_ptr<PluginAbstractFactory> factory,
+        PluginFunctionCache & functionCache)
+    throw(std::invalid_argument)
+{
+    return processFunctions(functionObj, factory, &functionCache);
+}
+
+std::vector<std::shared_ptr<Function>> FunctionsdBlocksTranslator::processFunctions(
+        const nlohmann::json & functionObj,
+        std::shared_ptr<PluginAbstractFactory> factory,
+        PluginFunctionCache * functionCache)
+    throw(std::invalid_argument)
+{
+    BLOCKLY_TRACE_SPAN(span, "processFunctions");
     try {
         std::vector<std::shared_ptr<Function>> functions;
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"type"}, functionObj);
+        JsonSchema::Fields fields = FUNCTION_SCHEMA.validate(functionObj);
 
-        std::string typeStr = functionObj["type"];
+        std::string typeStr = *fields[FUNCTION_TYPE];
         if (typeStr.compare(FUNCTION_LIST_STR) == 0) {
-            UtilsJSON::checkPropertiesExists(std::vector<std::string>{"functionsList"}, functionObj);
+            if (fields[FUNCTION_LIST] == NULL) {
+                throw(std::invalid_argument("missing properties: functionsList"));
+            }
 
-            json functionList = functionObj["functionsList"];
+            const json & functionList = *fields[FUNCTION_LIST];
             for(auto it = functionList.begin(); it != functionList.end(); ++it) {
-                json actualFunction= *it;
+                const json & actualFunction= *it;
 
-                UtilsJSON::checkPropertiesExists(std::vector<std::string>{"type"}, actualFunction);
-                std::string actualType = actualFunction["type"];
+                JsonSchema::Fields actualFields = FUNCTION_SCHEMA.validate(actualFunction);
+                std::string actualType = *actualFields[FUNCTION_TYPE];
 
-                functions.push_back(processSingleFunction(actualType, actualFunction));
+                functions.push_back(processSingleFunction(actualType, actualFunction, factory, functionCache));
             }
         } else {
-            functions.push_back(processSingleFunction(typeStr, functionObj));
+            functions.push_back(processSingleFunction(typeStr, functionObj, factory, functionCache));
         }
         return functions;
     } catch (std::exception & e) {
@@ -64,32 +152,80 @@ std::vector<std::shared_ptr<Function>> FunctionsdBlocksTranslator::processFuncti
 
 std::shared_ptr<ValvePluginRouteFunction> FunctionsdBlocksTranslator::processValveFunction(
         const nlohmann::json & functionObj,
-        ValveNode::TruthTable & truthTable)
+        ValveNode::TruthTable & truthTable,
+        std::shared_ptr<PluginAbstractFactory> factory)
     throw(std::invalid_argument)
 {
+    BLOCKLY_TRACE_SPAN(span, "processValveFunction");
     try {
         PluginConfiguration configObj = fillConfigurationObj(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"truthTable"}, functionObj);
-        truthTable = parseTruthTable(functionObj["truthTable"]);
+        JsonSchema::Fields fields = VALVE_SCHEMA.validate(functionObj);
+        truthTable = parseTruthTable(*fields[VALVE_TRUTH_TABLE]);
 
-        return std::make_shared<ValvePluginRouteFunction>(std::shared_ptr<PluginAbstractFactory>(), configObj);
+        return std::make_shared<ValvePluginRouteFunction>(factory, configObj);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::processValveFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<PumpPluginFunction> FunctionsdBlocksTranslator::processPumpFunction(const nlohmann::json & functionObj, bool & reversible)
+std::shared_ptr<ValvePluginRouteFunction> FunctionsdBlocksTranslator::processValveFunction(
+        const nlohmann::json & functionObj,
+        int pinNumber,
+        TruthTableCache & truthTableCache,
+        TruthTableCache::TruthTablePtr & truthTable,
+        std::shared_ptr<PluginAbstractFactory> factory,
+        PluginFunctionCache & functionCache)
     throw(std::invalid_argument)
 {
+    BLOCKLY_TRACE_SPAN(span, "processValveFunction");
     try {
-        PluginConfiguration configObj = fillConfigurationObj(functionObj);
+        JsonSchema::Fields fields = VALVE_SCHEMA.validate(functionObj);
+        truthTable = truthTableCache.intern(*fields[VALVE_TRUTH_TABLE], pinNumber, FunctionsdBlocksTranslator::parseTruthTable);
+
+        std::shared_ptr<Function> valve = functionCache.intern(VALVE_FUNCTION_KIND, functionObj, [&functionObj, factory]() {
+            PluginConfiguration configObj = fillConfigurationObj(functionObj);
+            return std::make_shared<ValvePluginRouteFunction>(factory, configObj);
+        });
+        return std::static_pointer_cast<ValvePluginRouteFunction>(valve);
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("FunctionsdBlocksTranslator::processValveFunction. Exception ocurred " + std::string(e.what())));
+    }
+}
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"reversible"}, functionObj);
-        reversible = functionObj["reversible"];
+std::shared_ptr<PumpPluginFunction> FunctionsdBlocksTranslator::processPumpFunction(
+        const nlohmann::json & functionObj,
+        bool & reversible,
+        std::shared_ptr<PluginAbstractFactory> factory,
+        PluginFunctionCache & functionCache)
+    throw(std::invalid_argument)
+{
+    try {
+        JsonSchema::Fields fields = PUMP_RANGE_SCHEMA.validate(functionObj);
+        reversible = *fields[P_REVERSIBLE];
+
+        std::shared_ptr<Function> pump = functionCache.intern(PUMP_FUNCTION_KIND, functionObj, [&functionObj, factory]() {
+            bool pumpReversible;
+            return processPumpFunction(functionObj, pumpReversible, factory);
+        });
+        return std::static_pointer_cast<PumpPluginFunction>(pump);
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("FunctionsdBlocksTranslator::processPumpFunction. Exception ocurred " + std::string(e.what())));
+    }
+}
 
-        PumpWorkingRange wRange = parsePumpWorkingRange(functionObj);
-        return std::make_shared<PumpPluginFunction>(std::shared_ptr<PluginAbstractFactory>(), configObj, wRange);
+std::shared_ptr<PumpPluginFunction> FunctionsdBlocksTranslator::processPumpFunction(
+        const nlohmann::json & functionObj,
+        bool & reversible,
+        std::shared_ptr<PluginAbstractFactory> factory)
+    throw(std::invalid_argument)
+{
+    BLOCKLY_TRACE_SPAN(span, "processPumpFunction");
+    try {
+        PluginConfiguration configObj = fillConfigurationObj(functionObj);
+
+        PumpWorkingRange wRange = parsePumpWorkingRange(functionObj, reversible);
+        return std::make_shared<PumpPluginFunction>(factory, configObj, wRange);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::processPumpFunction. Exception ocurred " + std::string(e.what())));
     }
@@ -101,19 +237,15 @@ void FunctionsdBlocksTranslator::processOpenGlasswareFunction(
         units::Volume & maxVolume)
     throw(std::invalid_argument)
 {
+    BLOCKLY_TRACE_SPAN(span, "processGlasswareFunction");
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minVolume",
-                                             "minVolumeUnits",
-                                             "maxVolume",
-                                             "maxVolumeUnits"
-                                         }, functionObj);
+        JsonSchema::Fields fields = GLASSWARE_SCHEMA.validate(functionObj);
 
-       double minVolumeValue = functionObj["minVolume"];
-       minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-       double maxVolumeValue = functionObj["maxVolume"];
-       maxVolume = maxVolumeValue * UtilsJSON::getVolumeUnits(functionObj["maxVolumeUnits"]);
+        double maxVolumeValue = *fields[MAX_VOLUME];
+        maxVolume = maxVolumeValue * UtilsJSON::getVolumeUnits(*fields[MAX_VOLUME_UNITS]);
 
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::processOpenGlasswareFunction. Exception ocurred " + std::string(e.what())));
@@ -126,19 +258,15 @@ void FunctionsdBlocksTranslator::processCloseGlasswareFunction(
         units::Volume & maxVolume)
     throw(std::invalid_argument)
 {
+    BLOCKLY_TRACE_SPAN(span, "processGlasswareFunction");
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minVolume",
-                                             "minVolumeUnits",
-                                             "maxVolume",
-                                             "maxVolumeUnits"
-                                         }, functionObj);
-
-       double minVolumeValue = functionObj["minVolume"];
-       minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
-
-       double maxVolumeValue = functionObj["maxVolume"];
-       maxVolume = maxVolumeValue * UtilsJSON::getVolumeUnits(functionObj["maxVolumeUnits"]);
+        JsonSchema::Fields fields = GLASSWARE_SCHEMA.validate(functionObj);
+
+        double minVolumeValue = *fields[MIN_VOLUME];
+        minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
+
+        double maxVolumeValue = *fields[MAX_VOLUME];
+        maxVolume = maxVolumeValue * UtilsJSON::getVolumeUnits(*fields[MAX_VOLUME_UNITS]);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::processCloseGlasswareFunction. Exception ocurred " + std::string(e.what())));
     }
@@ -146,23 +274,26 @@ void FunctionsdBlocksTranslator::processCloseGlasswareFunction(
 
 PluginConfiguration FunctionsdBlocksTranslator::fillConfigurationObj(const nlohmann::json & pluginObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "block_type",
-                                             "type",
-                                             "paramsNumber"}, pluginObj);
-        std::string name = pluginObj["block_type"];
-        std::string pluginType = pluginObj["type"];
-
-        int paramsNumber = pluginObj["paramsNumber"];
-        std::unordered_map<std::string,std::string> params;
-        for(int i=0; i < paramsNumber; i++) {
-            std::string actualName = "name" + std::to_string(i);
-            std::string actualValue = "value" + std::to_string(i);
+        JsonSchema::Fields fields = PLUGIN_SCHEMA.validate(pluginObj);
+        std::string name = *fields[PLUGIN_BLOCK_TYPE];
+        std::string pluginType = *fields[PLUGIN_TYPE];
+
+        int paramsNumber = *fields[PLUGIN_PARAMS_NUMBER];
+        //every param needs its own name and value fields, a larger number can only be a malformed descriptor
+        if (paramsNumber < 0 || static_cast<size_t>(paramsNumber) * 2 > pluginObj.size()) {
+            throw(std::invalid_argument("paramsNumber " + std::to_string(paramsNumber) + " does not match the plugin fields"));
+        }
 
-            UtilsJSON::checkPropertiesExists(std::vector<std::string>{actualName, actualValue}, pluginObj);
+        IndexedFieldsExtractor paramsExtractor(0, paramsNumber);
+        int namePrefix = paramsExtractor.addPrefix("name");
+        int valuePrefix = paramsExtractor.addPrefix("value");
+        paramsExtractor.extract(pluginObj);
+        paramsExtractor.checkComplete();
 
-            std::string nameStr = pluginObj[actualName];
-            std::string valueStr = InputsBlocksTranslator::processInput(pluginObj[actualValue]);
+        std::unordered_map<std::string,std::string> params;
+        for(int i=0; i < paramsNumber; i++) {
+            std::string nameStr = *paramsExtractor.getField(namePrefix, i);
+            std::string valueStr = InputsBlocksTranslator::processInput(*paramsExtractor.getField(valuePrefix, i));
             params.insert(std::make_pair(nameStr, valueStr));
         }
 
@@ -178,13 +309,12 @@ ValveNode::TruthTable FunctionsdBlocksTranslator::parseTruthTable(const nlohmann
     try {
         ValveNode::TruthTable tTable;
         for(auto it = truthTableObj.begin(); it != truthTableObj.end(); ++it) {
-            json row = *it;
-            UtilsJSON::checkPropertiesExists(std::vector<std::string>{"position", "connected_pins"}, row);
+            JsonSchema::Fields fields = TRUTH_TABLE_ROW_SCHEMA.validate(*it);
 
-            int position = row["position"];
-            std::vector<std::unordered_set<int>> connectedPins = parseConnectedPins(row["connected_pins"]);
+            int position = *fields[ROW_POSITION];
+            std::vector<std::unordered_set<int>> connectedPins = parseConnectedPins(*fields[ROW_CONNECTED_PINS]);
 
-            tTable.insert(std::make_pair(position, connectedPins));
+            tTable.insert(std::make_pair(position, std::move(connectedPins)));
         }
         return tTable;
     } catch (std::exception & e) {
@@ -194,200 +324,218 @@ ValveNode::TruthTable FunctionsdBlocksTranslator::parseTruthTable(const nlohmann
 
 std::vector<std::unordered_set<int>> FunctionsdBlocksTranslator::parseConnectedPins(const nlohmann::json & connectedPins) {
     std::vector<std::unordered_set<int>> connectedPinsVector;
+    connectedPinsVector.reserve(connectedPins.size());
     for(auto it = connectedPins.begin(); it != connectedPins.end(); ++it) {
-        json connectedPinsElem = *it;
+        const json & connectedPinsElem = *it;
         std::unordered_set<int> connectedPinsSet;
+        connectedPinsSet.reserve(connectedPinsElem.size());
 
         for(auto itElem = connectedPinsElem.begin(); itElem != connectedPinsElem.end(); ++itElem) {
             int elemPin = *itElem;
             connectedPinsSet.insert(elemPin);
         }
-        connectedPinsVector.push_back(connectedPinsSet);
+        connectedPinsVector.push_back(std::move(connectedPinsSet));
     }
     return connectedPinsVector;
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::processSingleFunction(const std::string & typeStr, const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::processSingleFunction(
+        const std::string & typeStr,
+        const nlohmann::json & functionObj,
+        std::shared_ptr<PluginAbstractFactory> factory,
+        PluginFunctionCache * functionCache)
+    throw(std::invalid_argument)
+{
     std::shared_ptr<Function> actualFunction;
 
+    const FunctionsMap & functionsTypeMap = getFunctionsTypeMap();
     auto finded = functionsTypeMap.find(typeStr);
     if (finded != functionsTypeMap.end()) {
-        std::function<std::shared_ptr<Function>(const nlohmann::json &)> typeFunction = finded->second;
-        actualFunction = typeFunction(functionObj);
+        BLOCKLY_TRACE_SPAN(span, "parseFunction");
+        BLOCKLY_TRACE_ARG(span, "type", typeStr);
+
+        const FunctionParser & typeFunction = finded->second;
+        if (functionCache != NULL) {
+            actualFunction = functionCache->intern(typeStr, functionObj, [&typeFunction, &functionObj, factory]() {
+                return typeFunction(functionObj, factory);
+            });
+        } else {
+            actualFunction = typeFunction(functionObj, factory);
+        }
     } else {
         throw(std::invalid_argument("unknow type: " + typeStr));
     }
     return actualFunction;
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseElectrophorerFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseElectrophorerFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
         ElectrophoresisWorkingRange range = parseElectrophoresisWorkingRange(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<ElectrophoresisFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume, range);
+        return std::make_shared<ElectrophoresisFunction>(factory, configuration, minVolume, range);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseElectrophorerFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseLightFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseLightFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
         LigthWorkingRange range = parseLghtsWorkingRange(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<LightFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume, range);
+        return std::make_shared<LightFunction>(factory, configuration, minVolume, range);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseLightFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseHeatFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseHeatFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
         HeaterWorkingRange range = parseHeatersWorkingRange(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<HeatFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume, range);
+        return std::make_shared<HeatFunction>(factory, configuration, minVolume, range);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseHeatFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseFluorescenceSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseFluorescenceSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
         MeasureFluorescenceWorkingRange range = parseMeasureFluorescenceWorkingRange(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<MeasureFluorescenceFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume, range);
+        return std::make_shared<MeasureFluorescenceFunction>(factory, configuration, minVolume, range);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseFluorescenceSensorFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseOdSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseOdSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
         MeasureOdWorkingRange range = parseMeasureOdWorkingRange(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<MeasureOdFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume, range);
+        return std::make_shared<MeasureOdFunction>(factory, configuration, minVolume, range);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseOdSensorFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseLuminiscenceSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseLuminiscenceSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<MeasureLuminiscenceFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume);
+        return std::make_shared<MeasureLuminiscenceFunction>(factory, configuration, minVolume);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseLuminiscenceSensorFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseVolumeSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseVolumeSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<MeasureVolumeFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume);
+        return std::make_shared<MeasureVolumeFunction>(factory, configuration, minVolume);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseVolumeSensorFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseTemperatureSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseTemperatureSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<MeasureTemperatureFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume);
+        return std::make_shared<MeasureTemperatureFunction>(factory, configuration, minVolume);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseTemperatureSensorFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseStirFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseStirFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
         StirWorkingRange range = parseStirWorkingRange(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<StirFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume, range);
+        return std::make_shared<StirFunction>(factory, configuration, minVolume, range);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseStirFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseShakeFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseShakeFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
         ShakeWorkingRange range = parseShakerWorkingRange(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<ShakeFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume, range);
+        return std::make_shared<ShakeFunction>(factory, configuration, minVolume, range);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseShakeFunction. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::shared_ptr<Function> FunctionsdBlocksTranslator::parseCentrifugateFunction(const nlohmann::json & functionObj) throw(std::invalid_argument) {
+std::shared_ptr<Function> FunctionsdBlocksTranslator::parseCentrifugateFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument) {
     try {
         PluginConfiguration configuration = fillConfigurationObj(functionObj);
         CentrifugationWorkingRange range = parseCentrifugationWorkingRange(functionObj);
 
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"minVolume", "minVolumeUnits"}, functionObj);
+        JsonSchema::Fields fields = MIN_VOLUME_SCHEMA.validate(functionObj);
 
-        double minVolumeValue = functionObj["minVolume"];
-        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(functionObj["minVolumeUnits"]);
+        double minVolumeValue = *fields[MIN_VOLUME];
+        units::Volume minVolume = minVolumeValue * UtilsJSON::getVolumeUnits(*fields[MIN_VOLUME_UNITS]);
 
-        return std::make_shared<CentrifugateFunction>(std::shared_ptr<PluginAbstractFactory>(),configuration, minVolume, range);
+        return std::make_shared<CentrifugateFunction>(factory, configuration, minVolume, range);
     } catch (std::exception & e) {
         throw(std::invalid_argument("FunctionsdBlocksTranslator::parseCentrifugateFunction. Exception ocurred " + std::string(e.what())));
     }
@@ -395,17 +543,13 @@ std::shared_ptr<Function> FunctionsdBlocksTranslator::parseCentrifugateFunction(
 
 CentrifugationWorkingRange FunctionsdBlocksTranslator::parseCentrifugationWorkingRange(const nlohmann::json & centrifugateObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minRange",
-                                             "minRangeUnits",
-                                             "maxRange",
-                                             "maxRangeUnits"}, centrifugateObj);
+        JsonSchema::Fields fields = RANGE_SCHEMA.validate(centrifugateObj);
 
-        double minRateValue = centrifugateObj["minRange"];
-        units::Frequency minRate = minRateValue * UtilsJSON::getFrequencyUnits(centrifugateObj["minRangeUnits"]);
+        double minRateValue = *fields[MIN_RANGE];
+        units::Frequency minRate = minRateValue * UtilsJSON::getFrequencyUnits(*fields[MIN_RANGE_UNITS]);
 
-        double maxRateValue = centrifugateObj["maxRange"];
-        units::Frequency maxRate = maxRateValue * UtilsJSON::getFrequencyUnits(centrifugateObj["maxRangeUnits"]);
+        double maxRateValue = *fields[MAX_RANGE];
+        units::Frequency maxRate = maxRateValue * UtilsJSON::getFrequencyUnits(*fields[MAX_RANGE_UNITS]);
 
         return CentrifugationWorkingRange(minRate, maxRate);
     } catch (std::exception & e) {
@@ -415,21 +559,15 @@ CentrifugationWorkingRange FunctionsdBlocksTranslator::parseCentrifugationWorkin
 
 ElectrophoresisWorkingRange FunctionsdBlocksTranslator::parseElectrophoresisWorkingRange(const nlohmann::json & electrophorerObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minRange",
-                                             "minRageEFieldUnits",
-                                             "minRageLengthUnits",
-                                             "maxRange",
-                                             "maxRageEFieldUnits",
-                                             "maxRageLengthUnits"}, electrophorerObj);
-
-        double minRateValue = electrophorerObj["minRange"];
+        JsonSchema::Fields fields = ELECTROPHORESIS_RANGE_SCHEMA.validate(electrophorerObj);
+
+        double minRateValue = *fields[E_MIN_RANGE];
         units::ElectricField minRate = minRateValue *
-                (UtilsJSON::getElectricPotentialUnits(electrophorerObj["minRageEFieldUnits"]) / UtilsJSON::getLengthUnits(electrophorerObj["minRageLengthUnits"]));
+                (UtilsJSON::getElectricPotentialUnits(*fields[E_MIN_FIELD_UNITS]) / UtilsJSON::getLengthUnits(*fields[E_MIN_LENGTH_UNITS]));
 
-        double maxRateValue = electrophorerObj["maxRange"];
+        double maxRateValue = *fields[E_MAX_RANGE];
         units::ElectricField maxRate = maxRateValue *
-                (UtilsJSON::getElectricPotentialUnits(electrophorerObj["maxRageEFieldUnits"]) / UtilsJSON::getLengthUnits(electrophorerObj["maxRageLengthUnits"]));
+                (UtilsJSON::getElectricPotentialUnits(*fields[E_MAX_FIELD_UNITS]) / UtilsJSON::getLengthUnits(*fields[E_MAX_LENGTH_UNITS]));
 
         return ElectrophoresisWorkingRange(minRate, maxRate);
     } catch (std::exception & e) {
@@ -439,17 +577,13 @@ ElectrophoresisWorkingRange FunctionsdBlocksTranslator::parseElectrophoresisWork
 
 HeaterWorkingRange FunctionsdBlocksTranslator::parseHeatersWorkingRange(const nlohmann::json & heaterObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minRange",
-                                             "minRangeUnits",
-                                             "maxRange",
-                                             "maxRangeUnits"}, heaterObj);
+        JsonSchema::Fields fields = RANGE_SCHEMA.validate(heaterObj);
 
-        double minRateValue = heaterObj["minRange"];
-        units::Temperature minRate = minRateValue * UtilsJSON::getTemperatureUnits(heaterObj["minRangeUnits"]);
+        double minRateValue = *fields[MIN_RANGE];
+        units::Temperature minRate = minRateValue * UtilsJSON::getTemperatureUnits(*fields[MIN_RANGE_UNITS]);
 
-        double maxRateValue = heaterObj["maxRange"];
-        units::Temperature maxRate = maxRateValue * UtilsJSON::getTemperatureUnits(heaterObj["maxRangeUnits"]);
+        double maxRateValue = *fields[MAX_RANGE];
+        units::Temperature maxRate = maxRateValue * UtilsJSON::getTemperatureUnits(*fields[MAX_RANGE_UNITS]);
 
         return HeaterWorkingRange(minRate, maxRate);
     } catch (std::exception & e) {
@@ -459,27 +593,19 @@ HeaterWorkingRange FunctionsdBlocksTranslator::parseHeatersWorkingRange(const nl
 
 LigthWorkingRange FunctionsdBlocksTranslator::parseLghtsWorkingRange(const nlohmann::json & lightObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minWavelength",
-                                             "minWavelengthUnits",
-                                             "maxWavelength",
-                                             "maxWavelengthUnits",
-                                             "minIntensity",
-                                             "minIntensityUnits",
-                                             "maxIntensity",
-                                             "maxIntensityUnits"}, lightObj);
+        JsonSchema::Fields fields = LIGHT_RANGE_SCHEMA.validate(lightObj);
 
-        double minWavelengthValue = lightObj["minWavelength"];
-        units::Length minWavelength = minWavelengthValue * UtilsJSON::getLengthUnits(lightObj["minWavelengthUnits"]);
+        double minWavelengthValue = *fields[MIN_WAVELENGTH];
+        units::Length minWavelength = minWavelengthValue * UtilsJSON::getLengthUnits(*fields[MIN_WAVELENGTH_UNITS]);
 
-        double maxWavelengthValue = lightObj["maxWavelength"];
-        units::Length maxWavelength = maxWavelengthValue * UtilsJSON::getLengthUnits(lightObj["maxWavelengthUnits"]);
+        double maxWavelengthValue = *fields[MAX_WAVELENGTH];
+        units::Length maxWavelength = maxWavelengthValue * UtilsJSON::getLengthUnits(*fields[MAX_WAVELENGTH_UNITS]);
 
-        double minIntensityValue = lightObj["minIntensity"];
-        units::LuminousIntensity minIntensity = minIntensityValue * UtilsJSON::getLuminousIntensityUnits(lightObj["minIntensityUnits"]);
+        double minIntensityValue = *fields[MIN_INTENSITY];
+        units::LuminousIntensity minIntensity = minIntensityValue * UtilsJSON::getLuminousIntensityUnits(*fields[MIN_INTENSITY_UNITS]);
 
-        double maxIntensityValue = lightObj["maxIntensity"];
-        units::LuminousIntensity maxIntensity = maxIntensityValue * UtilsJSON::getLuminousIntensityUnits(lightObj["maxIntensityUnits"]);
+        double maxIntensityValue = *fields[MAX_INTENSITY];
+        units::LuminousIntensity maxIntensity = maxIntensityValue * UtilsJSON::getLuminousIntensityUnits(*fields[MAX_INTENSITY_UNITS]);
 
         return LigthWorkingRange(minWavelength, maxWavelength, minIntensity, maxIntensity);
     } catch (std::exception & e) {
@@ -489,27 +615,19 @@ LigthWorkingRange FunctionsdBlocksTranslator::parseLghtsWorkingRange(const nlohm
 
 MeasureFluorescenceWorkingRange FunctionsdBlocksTranslator::parseMeasureFluorescenceWorkingRange(const nlohmann::json & measureFluorescenceObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minEmission",
-                                             "minEmissionUnits",
-                                             "maxEmission",
-                                             "maxEmissionUnits",
-                                             "minExcitation",
-                                             "minExcitationUnits",
-                                             "maxExcitation",
-                                             "maxExcitationUnits"}, measureFluorescenceObj);
+        JsonSchema::Fields fields = FLUORESCENCE_RANGE_SCHEMA.validate(measureFluorescenceObj);
 
-        double minEmissionValue = measureFluorescenceObj["minEmission"];
-        units::Length minEmission = minEmissionValue * UtilsJSON::getLengthUnits(measureFluorescenceObj["minEmissionUnits"]);
+        double minEmissionValue = *fields[MIN_EMISSION];
+        units::Length minEmission = minEmissionValue * UtilsJSON::getLengthUnits(*fields[MIN_EMISSION_UNITS]);
 
-        double maxEmissionValue = measureFluorescenceObj["maxEmission"];
-        units::Length maxEmission = maxEmissionValue * UtilsJSON::getLengthUnits(measureFluorescenceObj["maxEmissionUnits"]);
+        double maxEmissionValue = *fields[MAX_EMISSION];
+        units::Length maxEmission = maxEmissionValue * UtilsJSON::getLengthUnits(*fields[MAX_EMISSION_UNITS]);
 
-        double minExcitationValue = measureFluorescenceObj["minExcitation"];
-        units::Length minExcitation = minExcitationValue * UtilsJSON::getLengthUnits(measureFluorescenceObj["minExcitationUnits"]);
+        double minExcitationValue = *fields[MIN_EXCITATION];
+        units::Length minExcitation = minExcitationValue * UtilsJSON::getLengthUnits(*fields[MIN_EXCITATION_UNITS]);
 
-        double maxExcitationValue = measureFluorescenceObj["maxExcitation"];
-        units::Length maxExcitation = maxExcitationValue * UtilsJSON::getLengthUnits(measureFluorescenceObj["maxExcitationUnits"]);
+        double maxExcitationValue = *fields[MAX_EXCITATION];
+        units::Length maxExcitation = maxExcitationValue * UtilsJSON::getLengthUnits(*fields[MAX_EXCITATION_UNITS]);
 
         return MeasureFluorescenceWorkingRange(minEmission, maxEmission, minExcitation, maxExcitation);
     } catch (std::exception & e) {
@@ -519,17 +637,13 @@ MeasureFluorescenceWorkingRange FunctionsdBlocksTranslator::parseMeasureFluoresc
 
 MeasureOdWorkingRange FunctionsdBlocksTranslator::parseMeasureOdWorkingRange(const nlohmann::json & measureOdObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minRange",
-                                             "minRangeUnits",
-                                             "maxRange",
-                                             "maxRangeUnits"}, measureOdObj);
+        JsonSchema::Fields fields = RANGE_SCHEMA.validate(measureOdObj);
 
-        double minRateValue = measureOdObj["minRange"];
-        units::Length minRate = minRateValue * UtilsJSON::getLengthUnits(measureOdObj["minRangeUnits"]);
+        double minRateValue = *fields[MIN_RANGE];
+        units::Length minRate = minRateValue * UtilsJSON::getLengthUnits(*fields[MIN_RANGE_UNITS]);
 
-        double maxRateValue = measureOdObj["maxRange"];
-        units::Length maxRate = maxRateValue * UtilsJSON::getLengthUnits(measureOdObj["maxRangeUnits"]);
+        double maxRateValue = *fields[MAX_RANGE];
+        units::Length maxRate = maxRateValue * UtilsJSON::getLengthUnits(*fields[MAX_RANGE_UNITS]);
 
         return MeasureOdWorkingRange(minRate, maxRate);
     } catch (std::exception & e) {
@@ -537,21 +651,16 @@ MeasureOdWorkingRange FunctionsdBlocksTranslator::parseMeasureOdWorkingRange(con
     }
 }
 
-PumpWorkingRange FunctionsdBlocksTranslator::parsePumpWorkingRange(const nlohmann::json & pumpObj) throw(std::invalid_argument) {
+PumpWorkingRange FunctionsdBlocksTranslator::parsePumpWorkingRange(const nlohmann::json & pumpObj, bool & reversible) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minRange",
-                                             "minRangeVolumeUnits",
-                                             "minRangeTimeUnits",
-                                             "maxRange",
-                                             "maxRangeVolumeUnits",
-                                             "maxRangeTimeUnits"}, pumpObj);
+        JsonSchema::Fields fields = PUMP_RANGE_SCHEMA.validate(pumpObj);
+        reversible = *fields[P_REVERSIBLE];
 
-        double minRateValue = pumpObj["minRange"];
-        units::Volumetric_Flow minRate = minRateValue * (UtilsJSON::getVolumeUnits(pumpObj["minRangeVolumeUnits"]) / UtilsJSON::getTimeUnits(pumpObj["minRangeTimeUnits"]));
+        double minRateValue = *fields[P_MIN_RANGE];
+        units::Volumetric_Flow minRate = minRateValue * (UtilsJSON::getVolumeUnits(*fields[P_MIN_VOLUME_UNITS]) / UtilsJSON::getTimeUnits(*fields[P_MIN_TIME_UNITS]));
 
-        double maxRateValue = pumpObj["maxRange"];
-        units::Volumetric_Flow maxRate = maxRateValue * (UtilsJSON::getVolumeUnits(pumpObj["maxRangeVolumeUnits"]) / UtilsJSON::getTimeUnits(pumpObj["maxRangeTimeUnits"]));
+        double maxRateValue = *fields[P_MAX_RANGE];
+        units::Volumetric_Flow maxRate = maxRateValue * (UtilsJSON::getVolumeUnits(*fields[P_MAX_VOLUME_UNITS]) / UtilsJSON::getTimeUnits(*fields[P_MAX_TIME_UNITS]));
 
         return PumpWorkingRange(minRate, maxRate);
     } catch (std::exception & e) {
@@ -561,17 +670,13 @@ PumpWorkingRange FunctionsdBlocksTranslator::parsePumpWorkingRange(const nlohman
 
 ShakeWorkingRange FunctionsdBlocksTranslator::parseShakerWorkingRange(const nlohmann::json & shakerObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minRange",
-                                             "minRangeUnits",
-                                             "maxRange",
-                                             "maxRangeUnits"}, shakerObj);
+        JsonSchema::Fields fields = RANGE_SCHEMA.validate(shakerObj);
 
-        double minRateValue = shakerObj["minRange"];
-        units::Frequency minRate = minRateValue * UtilsJSON::getFrequencyUnits(shakerObj["minRangeUnits"]);
+        double minRateValue = *fields[MIN_RANGE];
+        units::Frequency minRate = minRateValue * UtilsJSON::getFrequencyUnits(*fields[MIN_RANGE_UNITS]);
 
-        double maxRateValue = shakerObj["maxRange"];
-        units::Frequency maxRate = maxRateValue * UtilsJSON::getFrequencyUnits(shakerObj["maxRangeUnits"]);
+        double maxRateValue = *fields[MAX_RANGE];
+        units::Frequency maxRate = maxRateValue * UtilsJSON::getFrequencyUnits(*fields[MAX_RANGE_UNITS]);
 
         return ShakeWorkingRange(minRate, maxRate);
     } catch (std::exception & e) {
@@ -581,17 +686,13 @@ ShakeWorkingRange FunctionsdBlocksTranslator::parseShakerWorkingRange(const nloh
 
 StirWorkingRange FunctionsdBlocksTranslator::parseStirWorkingRange(const nlohmann::json & stirObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{
-                                             "minRange",
-                                             "minRangeUnits",
-                                             "maxRange",
-                                             "maxRangeUnits"}, stirObj);
+        JsonSchema::Fields fields = RANGE_SCHEMA.validate(stirObj);
 
-        double minRateValue = stirObj["minRange"];
-        units::Frequency minRate = minRateValue * UtilsJSON::getFrequencyUnits(stirObj["minRangeUnits"]);
+        double minRateValue = *fields[MIN_RANGE];
+        units::Frequency minRate = minRateValue * UtilsJSON::getFrequencyUnits(*fields[MIN_RANGE_UNITS]);
 
-        double maxRateValue = stirObj["maxRange"];
-        units::Frequency maxRate = maxRateValue * UtilsJSON::getFrequencyUnits(stirObj["maxRangeUnits"]);
+        double maxRateValue = *fields[MAX_RANGE];
+        units::Frequency maxRate = maxRateValue * UtilsJSON::getFrequencyUnits(*fields[MAX_RANGE_UNITS]);
 
         return StirWorkingRange(minRate, maxRate);
     } catch (std::exception & e) {
@@ -41,10 +41,16 @@
 #include <utils/utilsjson.h>
 
 #include "blocklyFluidicMachineTranslator/blocks/inputsblockstranslator.h"
+#include "blocklyFluidicMachineTranslator/blocks/pluginfunctioncache.h"
+#include "blocklyFluidicMachineTranslator/blocks/truthtablecache.h"
+#include "blocklyFluidicMachineTranslator/json/indexedfieldsextractor.h"
+#include "blocklyFluidicMachineTranslator/json/jsonschema.h"
+#include "blocklyFluidicMachineTranslator/tracing/tracer.h"
 
 class FunctionsdBlocksTranslator
 {
-    typedef std::unordered_map<std::string, std::function<std::shared_ptr<Function>(const nlohmann::json &)>> FunctionsMap;
+    typedef std::function<std::shared_ptr<Function>(const nlohmann::json &, std::shared_ptr<PluginAbstractFactory>)> FunctionParser;
+    typedef std::unordered_map<std::string, FunctionParser> FunctionsMap;
 
     static const std::string ELECTROPHORER_STR;
     static const std::string LIGHT_STR;
@@ -58,20 +64,55 @@ class FunctionsdBlocksTranslator
     static const std::string SHAKE_STR;
     static const std::string CENTRIFUGATE_STR;
     static const std::string FUNCTION_LIST_STR;
-
-    static const FunctionsMap functionsTypeMap;
+    static const std::string PUMP_FUNCTION_KIND;
+    static const std::string VALVE_FUNCTION_KIND;
+
+    static const JsonSchema FUNCTION_SCHEMA;
+    static const JsonSchema PLUGIN_SCHEMA;
+    static const JsonSchema VALVE_SCHEMA;
+    static const JsonSchema GLASSWARE_SCHEMA;
+    static const JsonSchema MIN_VOLUME_SCHEMA;
+    static const JsonSchema TRUTH_TABLE_ROW_SCHEMA;
+    static const JsonSchema RANGE_SCHEMA;
+    static const JsonSchema ELECTROPHORESIS_RANGE_SCHEMA;
+    static const JsonSchema LIGHT_RANGE_SCHEMA;
+    static const JsonSchema FLUORESCENCE_RANGE_SCHEMA;
+    static const JsonSchema PUMP_RANGE_SCHEMA;
 
     static FunctionsMap makeFunctionsMap();
+    static const FunctionsMap & getFunctionsTypeMap();
 
 public:
     virtual ~FunctionsdBlocksTranslator(){}
 
-    static std::vector<std::shared_ptr<Function>> processFunctions(const nlohmann::json & functionObj) throw(std::invalid_argument);
-
+    // the plugin functions are bound to factory as they are built. The overloads taking a PluginFunctionCache reuse the
+    // function already built for an identical descriptor.
+    static std::vector<std::shared_ptr<Function>> processFunctions(
+            const nlohmann::json & functionObj,
+            std::shared_ptr<PluginAbstractFactory> factory = std::shared_ptr<PluginAbstractFactory>()) throw(std::invalid_argument);
+    static std::vector<std::shared_ptr<Function>> processFunctions(const nlohmann::json & functionObj,
+                                                                   std::shared_ptr<PluginAbstractFactory> factory,
+                                                                   PluginFunctionCache & functionCache) throw(std::invalid_argument);
+
+    static std::shared_ptr<ValvePluginRouteFunction> processValveFunction(
+            const nlohmann::json & functionObj,
+            ValveNode::TruthTable & truthTable,
+            std::shared_ptr<PluginAbstractFactory> factory = std::shared_ptr<PluginAbstractFactory>()) throw(std::invalid_argument);
     static std::shared_ptr<ValvePluginRouteFunction> processValveFunction(const nlohmann::json & functionObj,
-                                                                          ValveNode::TruthTable & truthTable) throw(std::invalid_argument);
-
-    static std::shared_ptr<PumpPluginFunction> processPumpFunction(const nlohmann::json & functionObj, bool & reversible) throw(std::invalid_argument);
+                                                                          int pinNumber,
+                                                                          TruthTableCache & truthTableCache,
+                                                                          TruthTableCache::TruthTablePtr & truthTable,
+                                                                          std::shared_ptr<PluginAbstractFactory> factory,
+                                                                          PluginFunctionCache & functionCache) throw(std::invalid_argument);
+
+    static std::shared_ptr<PumpPluginFunction> processPumpFunction(
+            const nlohmann::json & functionObj,
+            bool & reversible,
+            std::shared_ptr<PluginAbstractFactory> factory = std::shared_ptr<PluginAbstractFactory>()) throw(std::invalid_argument);
+    static std::shared_ptr<PumpPluginFunction> processPumpFunction(const nlohmann::json & functionObj,
+                                                                   bool & reversible,
+                                                                   std::shared_ptr<PluginAbstractFactory> factory,
+                                                                   PluginFunctionCache & functionCache) throw(std::invalid_argument);
 
     static void processOpenGlasswareFunction(const nlohmann::json & functionObj,
                                              units::Volume & minVolume,
@@ -81,25 +122,33 @@ public:
                                               units::Volume & minVolume,
                                               units::Volume & maxVolume) throw(std::invalid_argument);
 
+    static ValveNode::TruthTable parseTruthTable(const nlohmann::json & truthTableObj) throw(std::invalid_argument);
+
 protected:
     static PluginConfiguration fillConfigurationObj(const nlohmann::json & pluginObj) throw(std::invalid_argument);
 
-    static ValveNode::TruthTable parseTruthTable(const nlohmann::json & truthTableObj) throw(std::invalid_argument);
     static std::vector<std::unordered_set<int>> parseConnectedPins(const nlohmann::json & connectedPins);
 
-    static std::shared_ptr<Function> processSingleFunction(const std::string & typeStr, const nlohmann::json & functionObj) throw(std::invalid_argument);
-
-    static std::shared_ptr<Function> parseElectrophorerFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseLightFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseHeatFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseFluorescenceSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseOdSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseLuminiscenceSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseVolumeSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseTemperatureSensorFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseStirFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseShakeFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
-    static std::shared_ptr<Function> parseCentrifugateFunction(const nlohmann::json & functionObj) throw(std::invalid_argument);
+    static std::vector<std::shared_ptr<Function>> processFunctions(const nlohmann::json & functionObj,
+                                                                   std::shared_ptr<PluginAbstractFactory> factory,
+                                                                   PluginFunctionCache * functionCache) throw(std::invalid_argument);
+
+    static std::shared_ptr<Function> processSingleFunction(const std::string & typeStr,
+                                                           const nlohmann::json & functionObj,
+                                                           std::shared_ptr<PluginAbstractFactory> factory,
+                                                           PluginFunctionCache * functionCache) throw(std::invalid_argument);
+
+    static std::shared_ptr<Function> parseElectrophorerFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseLightFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseHeatFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseFluorescenceSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseOdSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseLuminiscenceSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseVolumeSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseTemperatureSensorFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseStirFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseShakeFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<Function> parseCentrifugateFunction(const nlohmann::json & functionObj, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
 
     static CentrifugationWorkingRange parseCentrifugationWorkingRange(const nlohmann::json & centrifugateObj) throw(std::invalid_argument);
     static ElectrophoresisWorkingRange parseElectrophoresisWorkingRange(const nlohmann::json & electrophorerObj) throw(std::invalid_argument);
@@ -107,7 +156,7 @@ protected:
     static LigthWorkingRange parseLghtsWorkingRange(const nlohmann::json & lightObj) throw(std::invalid_argument);
     static MeasureFluorescenceWorkingRange parseMeasureFluorescenceWorkingRange(const nlohmann::json & measureFluorescenceObj) throw(std::invalid_argument);
     static MeasureOdWorkingRange parseMeasureOdWorkingRange(const nlohmann::json & measureOdObj) throw(std::invalid_argument);
-    static PumpWorkingRange parsePumpWorkingRange(const nlohmann::json & pumpObj) throw(std::invalid_argument);
+    static PumpWorkingRange parsePumpWorkingRange(const nlohmann::json & pumpObj, bool & reversible) throw(std::invalid_argument);
     static ShakeWorkingRange parseShakerWorkingRange(const nlohmann::json & shakerObj) throw(std::invalid_argument);
     static StirWorkingRange parseStirWorkingRange(const nlohmann::json & stirObj) throw(std::invalid_argument);
 };
@@ -5,22 +5,34 @@ const std::string InputsBlocksTranslator::MATH_NUMBER_LIST_STR = "number_list";
 const std::string InputsBlocksTranslator::STRING_STR = "text";
 const std::string InputsBlocksTranslator::STRING_LIST_STR = "text_list";
 
+const JsonSchema InputsBlocksTranslator::INPUT_SCHEMA({"block_type"});
+const JsonSchema InputsBlocksTranslator::NUMBER_SCHEMA({"value"});
+const JsonSchema InputsBlocksTranslator::STRING_SCHEMA({"TEXT"});
+const JsonSchema InputsBlocksTranslator::LIST_SCHEMA({"containerList"});
+
 using json = nlohmann::json;
 
-std::string InputsBlocksTranslator::processInput(const nlohmann::json & inputObj) throw(std::invalid_argument) {
+std::string InputsBlocksTranslator::processInput(const nlohmann::json & inputObj, size_t maxNestingDepth) throw(std::invalid_argument) {
+    return processInput(inputObj, maxNestingDepth, 1);
+}
+
+std::string InputsBlocksTranslator::processInput(const nlohmann::json & inputObj, size_t maxNestingDepth, size_t depth)
+    throw(std::invalid_argument)
+{
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"block_type"}, inputObj);
+        TranslationLimits::check(depth, maxNestingDepth, "input nesting depth");
+        JsonSchema::Fields fields = INPUT_SCHEMA.validate(inputObj);
 
         std::string input;
-        std::string type = inputObj["block_type"];
+        std::string type = *fields[0];
         if (type.compare(MATHBLOCK_NUMBER_STR) == 0) {
             input = processMathNumber(inputObj);
         } else if (type.compare(MATH_NUMBER_LIST_STR) == 0) {
-            input = processMathNumberList(inputObj);
+            input = processMathNumberList(inputObj, maxNestingDepth, depth);
         } else if (type.compare(STRING_STR) == 0) {
             input = processString(inputObj);
         } else if (type.compare(STRING_LIST_STR) == 0) {
-            input = processStringList(inputObj);
+            input = processStringList(inputObj, maxNestingDepth, depth);
         } else {
             throw(std::invalid_argument("unknow input type: " + type));
         }
@@ -32,27 +44,28 @@ std::string InputsBlocksTranslator::processInput(const nlohmann::json & inputObj
 
 std::string InputsBlocksTranslator::processMathNumber(const nlohmann::json & inputObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"value"}, inputObj);
+        JsonSchema::Fields fields = NUMBER_SCHEMA.validate(inputObj);
 
-        return inputObj["value"];
+        return *fields[0];
     } catch (std::exception & e) {
         throw(std::invalid_argument("InputsBlocksTranslator::processMathNumber. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::string InputsBlocksTranslator::processMathNumberList(const nlohmann::json & inputObj) throw(std::invalid_argument) {
+std::string InputsBlocksTranslator::processMathNumberList(const nlohmann::json & inputObj, size_t maxNestingDepth, size_t depth)
+    throw(std::invalid_argument)
+{
     try {
         std::stringstream numberList;
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"containerList"}, inputObj);
+        JsonSchema::Fields fields = LIST_SCHEMA.validate(inputObj);
 
-        json containerList = inputObj["containerList"];
+        const json & containerList = *fields[0];
 
-        auto it = containerList.begin();
-        numberList << processInput(*it);
-        ++it;
-
-        for(; it != containerList.end(); ++it) {
-            numberList << "," << processInput(*it);
+        for(auto it = containerList.begin(); it != containerList.end(); ++it) {
+            if (it != containerList.begin()) {
+                numberList << ",";
+            }
+            numberList << processInput(*it, maxNestingDepth, depth + 1);
         }
         return numberList.str();
     } catch (std::exception & e) {
@@ -62,26 +75,27 @@ std::string InputsBlocksTranslator::processMathNumberList(const nlohmann::json &
 
 std::string InputsBlocksTranslator::processString(const nlohmann::json & inputObj) throw(std::invalid_argument) {
     try {
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"TEXT"}, inputObj);
-        return inputObj["TEXT"];
+        JsonSchema::Fields fields = STRING_SCHEMA.validate(inputObj);
+        return *fields[0];
     } catch (std::exception & e) {
         throw(std::invalid_argument("InputsBlocksTranslator::processString. Exception ocurred " + std::string(e.what())));
     }
 }
 
-std::string InputsBlocksTranslator::processStringList(const nlohmann::json & inputObj) throw(std::invalid_argument) {
+std::string InputsBlocksTranslator::processStringList(const nlohmann::json & inputObj, size_t maxNestingDepth, size_t depth)
+    throw(std::invalid_argument)
+{
     try {
         std::stringstream textList;
-        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"containerList"}, inputObj);
-
-        json containerList = inputObj["containerList"];
+        JsonSchema::Fields fields = LIST_SCHEMA.validate(inputObj);
 
-        auto it = containerList.begin();
-        textList << processInput(*it);
-        ++it;
+        const json & containerList = *fields[0];
 
-        for(; it != containerList.end(); ++it) {
-            textList << "," << processInput(*it);
+        for(auto it = containerList.begin(); it != containerList.end(); ++it) {
+            if (it != containerList.begin()) {
+                textList << ",";
+            }
+            textList << processInput(*it, maxNestingDepth, depth + 1);
         }
         return textList.str();
     } catch (std::exception & e) {
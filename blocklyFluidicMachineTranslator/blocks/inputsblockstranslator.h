@@ -1,6 +1,7 @@
 #ifndef INPUTSBLOCKSTRANSLATOR_H
 #define INPUTSBLOCKSTRANSLATOR_H
 
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <sstream>
@@ -9,6 +10,9 @@
 
 #include <utils/utilsjson.h>
 
+#include "blocklyFluidicMachineTranslator/json/jsonschema.h"
+#include "blocklyFluidicMachineTranslator/translationlimits.h"
+
 class InputsBlocksTranslator
 {
     static const std::string MATHBLOCK_NUMBER_STR;
@@ -16,18 +20,26 @@ class InputsBlocksTranslator
     static const std::string STRING_STR;
     static const std::string STRING_LIST_STR;
 
+    static const JsonSchema INPUT_SCHEMA;
+    static const JsonSchema NUMBER_SCHEMA;
+    static const JsonSchema STRING_SCHEMA;
+    static const JsonSchema LIST_SCHEMA;
+
 public:
     virtual ~InputsBlocksTranslator(){}
 
-    static std::string processInput(const nlohmann::json & inputObj) throw(std::invalid_argument);
+    // number_list and text_list nest other inputs, maxNestingDepth bounds how many of them can be nested
+    static std::string processInput(const nlohmann::json & inputObj,
+                                    size_t maxNestingDepth = std::numeric_limits<size_t>::max()) throw(std::invalid_argument);
 
 protected:
+    static std::string processInput(const nlohmann::json & inputObj, size_t maxNestingDepth, size_t depth) throw(std::invalid_argument);
 
     static std::string processMathNumber(const nlohmann::json & inputObj) throw(std::invalid_argument);
-    static std::string processMathNumberList(const nlohmann::json & inputObj) throw(std::invalid_argument);
+    static std::string processMathNumberList(const nlohmann::json & inputObj, size_t maxNestingDepth, size_t depth) throw(std::invalid_argument);
 
     static std::string processString(const nlohmann::json & inputObj) throw(std::invalid_argument);
-    static std::string processStringList(const nlohmann::json & inputObj) throw(std::invalid_argument);
+    static std::string processStringList(const nlohmann::json & inputObj, size_t maxNestingDepth, size_t depth) throw(std::invalid_argument);
 };
 
 #endif // INPUTSBLOCKSTRANSLATOR_H
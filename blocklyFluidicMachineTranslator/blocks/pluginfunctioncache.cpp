@@ -0,0 +1,26 @@
+#include "pluginfunctioncache.h"
+
+PluginFunctionCache::PluginFunctionCache() {
+
+}
+
+PluginFunctionCache::~PluginFunctionCache() {
+
+}
+
+std::shared_ptr<Function> PluginFunctionCache::intern(const std::string & kind, const nlohmann::json & functionObj, FunctionMaker maker) {
+    std::string key = kind + ":" + functionObj.dump();
+
+    auto finded = functions.find(key);
+    if (finded != functions.end()) {
+        return finded->second;
+    }
+
+    std::shared_ptr<Function> function = maker();
+    functions.insert(std::make_pair(key, function));
+    return function;
+}
+
+void PluginFunctionCache::clear() {
+    functions.clear();
+}
@@ -0,0 +1,34 @@
+#ifndef PLUGINFUNCTIONCACHE_H
+#define PLUGINFUNCTIONCACHE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <json.hpp>
+
+#include <commonmodel/functions/function.h>
+
+// keeps the plugin functions already built during a translation so nodes with the same plugin set up (same kind of
+// function and same json descriptor) share a single instance instead of building one each.
+class PluginFunctionCache
+{
+public:
+    typedef std::function<std::shared_ptr<Function>()> FunctionMaker;
+
+    PluginFunctionCache();
+    virtual ~PluginFunctionCache();
+
+    std::shared_ptr<Function> intern(const std::string & kind, const nlohmann::json & functionObj, FunctionMaker maker);
+
+    size_t size() const {
+        return functions.size();
+    }
+    void clear();
+
+protected:
+    std::unordered_map<std::string, std::shared_ptr<Function>> functions;
+};
+
+#endif // PLUGINFUNCTIONCACHE_H
@@ -0,0 +1,84 @@
+#include "truthtablecache.h"
+
+TruthTableCache::TruthTableCache() {
+
+}
+
+TruthTableCache::~TruthTableCache() {
+
+}
+
+TruthTableCache::TruthTablePtr TruthTableCache::intern(const nlohmann::json & truthTableObj, int pinNumber, TruthTableParser parser)
+    throw(std::invalid_argument)
+{
+    std::string key = std::to_string(pinNumber) + "|" + truthTableObj.dump();
+
+    auto findedJson = tablesByJson.find(key);
+    if (findedJson != tablesByJson.end()) {
+        return findedJson->second;
+    }
+
+    TruthTablePtr parsed = std::make_shared<const ValveNode::TruthTable>(parser(truthTableObj));
+    uint64_t hash = hashTruthTable(*parsed, pinNumber);
+
+    TruthTablePtr table;
+    auto range = tablesByHash.equal_range(hash);
+    for(auto it = range.first; it != range.second && !table; ++it) {
+        if (*it->second == *parsed) {
+            table = it->second;
+        }
+    }
+    if (!table) {
+        table = parsed;
+        tablesByHash.insert(std::make_pair(hash, table));
+    }
+
+    tablesByJson.insert(std::make_pair(key, table));
+    return table;
+}
+
+void TruthTableCache::clear() {
+    tablesByJson.clear();
+    tablesByHash.clear();
+}
+
+uint64_t TruthTableCache::hashTruthTable(const ValveNode::TruthTable & table, int pinNumber) throw(std::invalid_argument) {
+    //the hashes of the positions and of the groups of a position are sorted before they are combined
+    std::vector<uint64_t> rowHashes;
+    rowHashes.reserve(table.size());
+    std::vector<uint64_t> groupHashes;
+    for(const auto & positionPair : table) {
+        groupHashes.clear();
+        for(const auto & connectedPins : positionPair.second) {
+            PortSet pinsSet;
+            for(int pin : connectedPins) {
+                //checked before the insert, the bitmask grows up to the largest pin
+                if (pin < 0 || pin >= pinNumber) {
+                    throw(std::invalid_argument("TruthTableCache::hashTruthTable. pin " + std::to_string(pin) +
+                                                " out of the " + std::to_string(pinNumber) + " pins of the valve"));
+                }
+                pinsSet.insert(pin);
+            }
+
+            uint64_t groupHash = pinsSet.size();
+            for(int pin : pinsSet.toVector()) {
+                groupHash = MachineFingerprint::combine(groupHash, pin);
+            }
+            groupHashes.push_back(groupHash);
+        }
+        std::sort(groupHashes.begin(), groupHashes.end());
+
+        uint64_t rowHash = MachineFingerprint::combine(positionPair.first, groupHashes.size());
+        for(uint64_t groupHash : groupHashes) {
+            rowHash = MachineFingerprint::combine(rowHash, groupHash);
+        }
+        rowHashes.push_back(rowHash);
+    }
+    std::sort(rowHashes.begin(), rowHashes.end());
+
+    uint64_t tableHash = table.size();
+    for(uint64_t rowHash : rowHashes) {
+        tableHash = MachineFingerprint::combine(tableHash, rowHash);
+    }
+    return tableHash;
+}
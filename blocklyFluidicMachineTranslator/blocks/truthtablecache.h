@@ -0,0 +1,47 @@
+#ifndef TRUTHTABLECACHE_H
+#define TRUTHTABLECACHE_H
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <json.hpp>
+
+#include <fluidicmachinemodel/fluidicnode/valvenode.h>
+
+#include "blocklyFluidicMachineTranslator/graph/machinefingerprint.h"
+#include "blocklyFluidicMachineTranslator/graph/portset.h"
+
+// interns the truth tables of the valves: a table is parsed only the first time its json is seen and equal tables,
+// even if written differently, are shared as one immutable instance. Tables are checked against the pins of the
+// valve, so the same json is interned once per number of pins.
+class TruthTableCache
+{
+public:
+    typedef std::shared_ptr<const ValveNode::TruthTable> TruthTablePtr;
+    typedef std::function<ValveNode::TruthTable(const nlohmann::json &)> TruthTableParser;
+
+    TruthTableCache();
+    virtual ~TruthTableCache();
+
+    TruthTablePtr intern(const nlohmann::json & truthTableObj, int pinNumber, TruthTableParser parser) throw(std::invalid_argument);
+
+    size_t size() const {
+        return tablesByHash.size();
+    }
+    void clear();
+
+    // structural hash of a table, stable between runs. The rows and the groups of connected pins of a row are hashed
+    // regardless of their order, the pins of a group as a PortSet
+    static uint64_t hashTruthTable(const ValveNode::TruthTable & table, int pinNumber) throw(std::invalid_argument);
+
+protected:
+    std::unordered_map<std::string, TruthTablePtr> tablesByJson;
+    std::unordered_multimap<uint64_t, TruthTablePtr> tablesByHash;
+};
+
+#endif // TRUTHTABLECACHE_H
@@ -0,0 +1,74 @@
+#include "componentpartition.h"
+
+ComponentPartition::ComponentPartition() {
+
+}
+
+ComponentPartition::~ComponentPartition() {
+
+}
+
+void ComponentPartition::addNode(int id) {
+    getIndex(id);
+}
+
+void ComponentPartition::unite(int first, int second) {
+    size_t firstRoot = findRoot(getIndex(first));
+    size_t secondRoot = findRoot(getIndex(second));
+    if (firstRoot == secondRoot) {
+        return;
+    }
+
+    //union by size keeps the trees shallow
+    if (sizes[firstRoot] < sizes[secondRoot]) {
+        std::swap(firstRoot, secondRoot);
+    }
+    parents[secondRoot] = firstRoot;
+    sizes[firstRoot] += sizes[secondRoot];
+}
+
+int ComponentPartition::find(int id) {
+    return ids[findRoot(getIndex(id))];
+}
+
+std::vector<std::vector<int>> ComponentPartition::getComponents() {
+    std::unordered_map<size_t, size_t> componentByRoot;
+    std::vector<std::vector<int>> components;
+
+    std::vector<int> sortedIds = ids;
+    std::sort(sortedIds.begin(), sortedIds.end());
+    for(int id : sortedIds) {
+        size_t root = findRoot(indexes[id]);
+
+        auto finded = componentByRoot.find(root);
+        if (finded == componentByRoot.end()) {
+            finded = componentByRoot.insert(std::make_pair(root, components.size())).first;
+            components.push_back(std::vector<int>());
+        }
+        components[finded->second].push_back(id);
+    }
+    return components;
+}
+
+size_t ComponentPartition::getIndex(int id) {
+    auto finded = indexes.find(id);
+    if (finded != indexes.end()) {
+        return finded->second;
+    }
+
+    size_t index = ids.size();
+    indexes.insert(std::make_pair(id, index));
+    ids.push_back(id);
+    parents.push_back(index);
+    sizes.push_back(1);
+    return index;
+}
+
+size_t ComponentPartition::findRoot(size_t index) {
+    //path halving
+    while(parents[index] != index) {
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+    return index;
+}
@@ -0,0 +1,33 @@
+#ifndef COMPONENTPARTITION_H
+#define COMPONENTPARTITION_H
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+// union-find over the node ids, used to split a machine into the groups of nodes that are joined by an edge or by a
+// valve twin group and so can be modelled independently of the others.
+class ComponentPartition
+{
+public:
+    ComponentPartition();
+    virtual ~ComponentPartition();
+
+    void addNode(int id);
+    void unite(int first, int second);
+    int find(int id);
+
+    // every component sorted by id, the components sorted by their first id
+    std::vector<std::vector<int>> getComponents();
+
+protected:
+    std::unordered_map<int, size_t> indexes;
+    std::vector<int> ids;
+    std::vector<size_t> parents;
+    std::vector<size_t> sizes;
+
+    size_t getIndex(int id);
+    size_t findRoot(size_t index);
+};
+
+#endif // COMPONENTPARTITION_H
@@ -0,0 +1,52 @@
+#include "machinefingerprint.h"
+
+#include <cstdio>
+
+MachineFingerprint::MachineFingerprint() :
+    value(0), nodes(0), edges(0)
+{
+
+}
+
+MachineFingerprint::MachineFingerprint(uint64_t value, size_t nodes, size_t edges) :
+    value(value), nodes(nodes), edges(edges)
+{
+
+}
+
+MachineFingerprint::~MachineFingerprint() {
+
+}
+
+std::string MachineFingerprint::toString() const {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+    return std::string(buffer);
+}
+
+bool MachineFingerprint::operator<(const MachineFingerprint & other) const {
+    if (value != other.value) {
+        return value < other.value;
+    }
+    if (nodes != other.nodes) {
+        return nodes < other.nodes;
+    }
+    return edges < other.edges;
+}
+
+uint64_t MachineFingerprint::hashBytes(const std::string & bytes) {
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for(unsigned char byte : bytes) {
+        hash ^= byte;
+        hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+uint64_t MachineFingerprint::combine(uint64_t seed, uint64_t value) {
+    //splitmix64 finalizer over the pair, so combine(a,b) != combine(b,a)
+    uint64_t mixed = seed * UINT64_C(0x9e3779b97f4a7c15) + value + UINT64_C(0x632be59bd9b4e019);
+    mixed = (mixed ^ (mixed >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    mixed = (mixed ^ (mixed >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return mixed ^ (mixed >> 31);
+}
@@ -0,0 +1,56 @@
+#ifndef MACHINEFINGERPRINT_H
+#define MACHINEFINGERPRINT_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// structural hash of a translated machine. It does not depend on the references, the order of the blocks nor the ids
+// given to the nodes, so two files describing the same machine get the same fingerprint. See MachineFingerprintBuilder.
+class MachineFingerprint
+{
+public:
+    MachineFingerprint();
+    MachineFingerprint(uint64_t value, size_t nodes, size_t edges);
+    virtual ~MachineFingerprint();
+
+    inline uint64_t getValue() const {
+        return value;
+    }
+    inline size_t getNodes() const {
+        return nodes;
+    }
+    inline size_t getEdges() const {
+        return edges;
+    }
+
+    // hexadecimal value, usable as a cache key
+    std::string toString() const;
+
+    bool operator==(const MachineFingerprint & other) const {
+        return value == other.value && nodes == other.nodes && edges == other.edges;
+    }
+    bool operator!=(const MachineFingerprint & other) const {
+        return !(*this == other);
+    }
+    bool operator<(const MachineFingerprint & other) const;
+
+    // FNV-1a, stable between runs and platforms unlike std::hash
+    static uint64_t hashBytes(const std::string & bytes);
+    static uint64_t combine(uint64_t seed, uint64_t value);
+
+protected:
+    uint64_t value;
+    size_t nodes;
+    size_t edges;
+};
+
+namespace std {
+template<> struct hash<MachineFingerprint> {
+    size_t operator()(const MachineFingerprint & fingerprint) const {
+        return static_cast<size_t>(fingerprint.getValue());
+    }
+};
+}
+
+#endif // MACHINEFINGERPRINT_H
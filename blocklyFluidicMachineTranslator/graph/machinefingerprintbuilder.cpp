@@ -0,0 +1,106 @@
+#include "machinefingerprintbuilder.h"
+
+MachineFingerprintBuilder::MachineFingerprintBuilder() :
+    edgesNumber(0)
+{
+
+}
+
+MachineFingerprintBuilder::~MachineFingerprintBuilder() {
+
+}
+
+void MachineFingerprintBuilder::addNode(int id, uint64_t label) {
+    labels[getIndex(id)] = label;
+}
+
+void MachineFingerprintBuilder::addEdge(int source, int target, int sourcePort, int targetPort) {
+    size_t sourceIndex = getIndex(source);
+    size_t targetIndex = getIndex(target);
+
+    //the direction is part of the edge label so a node tells its outgoing edges from the incoming ones
+    uint64_t outLabel = MachineFingerprint::combine(MachineFingerprint::combine(1, sourcePort), targetPort);
+    uint64_t inLabel = MachineFingerprint::combine(MachineFingerprint::combine(2, targetPort), sourcePort);
+
+    neighbours[sourceIndex].push_back(Neighbour(targetIndex, outLabel));
+    neighbours[targetIndex].push_back(Neighbour(sourceIndex, inLabel));
+    edgesNumber++;
+}
+
+void MachineFingerprintBuilder::addTwins(const std::unordered_set<int> & twins) {
+    //the group is joined through an unnamed hub node, so a group of n twins costs n neighbours instead of n^2
+    size_t hub = labels.size();
+    labels.push_back(MachineFingerprint::combine(3, twins.size()));
+    neighbours.push_back(std::vector<Neighbour>());
+
+    for(int twin : twins) {
+        size_t twinIndex = getIndex(twin);
+        neighbours[twinIndex].push_back(Neighbour(hub, 3));
+        neighbours[hub].push_back(Neighbour(twinIndex, 3));
+    }
+}
+
+MachineFingerprint MachineFingerprintBuilder::make() const {
+    std::vector<uint64_t> current = labels;
+    std::vector<uint64_t> next(current.size());
+    std::vector<uint64_t> neighbourLabels;
+
+    size_t distinct = countDistinct(current);
+    size_t maxRounds = getMaxRounds(current.size());
+    for(size_t round = 0; round < maxRounds; round++) {
+        for(size_t i = 0; i < current.size(); i++) {
+            neighbourLabels.clear();
+            for(const Neighbour & neighbour : neighbours[i]) {
+                neighbourLabels.push_back(MachineFingerprint::combine(neighbour.edgeLabel, current[neighbour.node]));
+            }
+            std::sort(neighbourLabels.begin(), neighbourLabels.end());
+
+            uint64_t label = current[i];
+            for(uint64_t neighbourLabel : neighbourLabels) {
+                label = MachineFingerprint::combine(label, neighbourLabel);
+            }
+            next[i] = label;
+        }
+        current.swap(next);
+
+        size_t refined = countDistinct(current);
+        if (refined <= distinct) {
+            break;
+        }
+        distinct = refined;
+    }
+
+    std::sort(current.begin(), current.end());
+    uint64_t value = MachineFingerprint::combine(indexes.size(), edgesNumber);
+    for(uint64_t label : current) {
+        value = MachineFingerprint::combine(value, label);
+    }
+    return MachineFingerprint(value, indexes.size(), edgesNumber);
+}
+
+size_t MachineFingerprintBuilder::getIndex(int id) {
+    auto finded = indexes.find(id);
+    if (finded != indexes.end()) {
+        return finded->second;
+    }
+
+    size_t index = labels.size();
+    indexes.insert(std::make_pair(id, index));
+    labels.push_back(0);
+    neighbours.push_back(std::vector<Neighbour>());
+    return index;
+}
+
+size_t MachineFingerprintBuilder::getMaxRounds(size_t nodes) {
+    size_t rounds = 1;
+    while (nodes > 1) {
+        nodes >>= 1;
+        rounds++;
+    }
+    return rounds;
+}
+
+size_t MachineFingerprintBuilder::countDistinct(std::vector<uint64_t> labels) {
+    std::sort(labels.begin(), labels.end());
+    return std::unique(labels.begin(), labels.end()) - labels.begin();
+}
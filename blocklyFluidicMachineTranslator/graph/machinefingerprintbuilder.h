@@ -0,0 +1,49 @@
+#ifndef MACHINEFINGERPRINTBUILDER_H
+#define MACHINEFINGERPRINTBUILDER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "blocklyFluidicMachineTranslator/graph/machinefingerprint.h"
+
+// computes a MachineFingerprint by Weisfeiler-Lehman refinement: every node starts with the hash of its own
+// description and each round mixes in the sorted labels of its neighbours, until the number of distinct labels stops
+// growing or after getMaxRounds() rounds. The fingerprint is the hash of the sorted final labels, so it does not depend
+// on the node ids.
+class MachineFingerprintBuilder
+{
+public:
+    MachineFingerprintBuilder();
+    virtual ~MachineFingerprintBuilder();
+
+    void addNode(int id, uint64_t label);
+    void addEdge(int source, int target, int sourcePort, int targetPort);
+    void addTwins(const std::unordered_set<int> & twins);
+
+    MachineFingerprint make() const;
+
+protected:
+    struct Neighbour {
+        size_t node;
+        uint64_t edgeLabel;
+
+        Neighbour(size_t node, uint64_t edgeLabel) :
+            node(node), edgeLabel(edgeLabel)
+        {}
+    };
+
+    std::unordered_map<int, size_t> indexes;
+    std::vector<uint64_t> labels;
+    std::vector<std::vector<Neighbour>> neighbours;
+    size_t edgesNumber;
+
+    size_t getIndex(int id);
+    // floor(log2(nodes)) + 1, so a long chain of equal nodes does not take a round per node
+    static size_t getMaxRounds(size_t nodes);
+    static size_t countDistinct(std::vector<uint64_t> labels);
+};
+
+#endif // MACHINEFINGERPRINTBUILDER_H
@@ -0,0 +1,101 @@
+#include "nodereordering.h"
+
+std::unordered_map<int,int> NodeReordering::makePermutation(Ordering ordering, const std::vector<int> & ids, const AdjacencyMap & adjacency) {
+    std::vector<int> sortedIds(ids);
+    std::sort(sortedIds.begin(), sortedIds.end());
+    sortedIds.erase(std::unique(sortedIds.begin(), sortedIds.end()), sortedIds.end());
+
+    std::unordered_map<int,int> permutation;
+    permutation.reserve(sortedIds.size());
+
+    if (ordering == reference_order) {
+        for(int id : sortedIds) {
+            permutation.insert(std::make_pair(id, id));
+        }
+        return permutation;
+    }
+
+    std::unordered_map<int,int> indexMap;
+    indexMap.reserve(sortedIds.size());
+    for(size_t i = 0; i < sortedIds.size(); i++) {
+        indexMap.insert(std::make_pair(sortedIds[i], i));
+    }
+
+    std::vector<std::vector<int>> neighbours(sortedIds.size());
+    for(const auto & adjacencyPair : adjacency) {
+        auto sourceIndex = indexMap.find(adjacencyPair.first);
+        if (sourceIndex != indexMap.end()) {
+            for(int target : adjacencyPair.second) {
+                auto targetIndex = indexMap.find(target);
+                if (targetIndex != indexMap.end() && targetIndex->second != sourceIndex->second) {
+                    neighbours[sourceIndex->second].push_back(targetIndex->second);
+                    neighbours[targetIndex->second].push_back(sourceIndex->second);
+                }
+            }
+        }
+    }
+    for(std::vector<int> & nodeNeighbours : neighbours) {
+        std::sort(nodeNeighbours.begin(), nodeNeighbours.end());
+        nodeNeighbours.erase(std::unique(nodeNeighbours.begin(), nodeNeighbours.end()), nodeNeighbours.end());
+    }
+
+    std::vector<int> order = breadthFirstOrder(neighbours, ordering == reverse_cuthill_mckee_order);
+    if (ordering == reverse_cuthill_mckee_order) {
+        std::reverse(order.begin(), order.end());
+    }
+
+    for(size_t i = 0; i < order.size(); i++) {
+        permutation.insert(std::make_pair(sortedIds[order[i]], sortedIds[i]));
+    }
+    return permutation;
+}
+
+std::vector<int> NodeReordering::breadthFirstOrder(const std::vector<std::vector<int>> & neighbours, bool minimumDegreeFirst) {
+    size_t size = neighbours.size();
+
+    std::vector<int> starts(size);
+    for(size_t i = 0; i < size; i++) {
+        starts[i] = i;
+    }
+    if (minimumDegreeFirst) {
+        //Cuthill-McKee: every component starts at a node of minimum degree and visits the neighbours by increasing degree
+        std::stable_sort(starts.begin(), starts.end(), [&neighbours](int a, int b) {
+            return neighbours[a].size() < neighbours[b].size();
+        });
+    }
+
+    std::vector<int> order;
+    order.reserve(size);
+
+    std::vector<bool> visited(size, false);
+    std::deque<int> queue;
+    std::vector<int> nextNodes;
+
+    for(int start : starts) {
+        if (!visited[start]) {
+            visited[start] = true;
+            queue.push_back(start);
+
+            while(!queue.empty()) {
+                int actual = queue.front();
+                queue.pop_front();
+                order.push_back(actual);
+
+                nextNodes.clear();
+                for(int neighbour : neighbours[actual]) {
+                    if (!visited[neighbour]) {
+                        visited[neighbour] = true;
+                        nextNodes.push_back(neighbour);
+                    }
+                }
+                if (minimumDegreeFirst) {
+                    std::stable_sort(nextNodes.begin(), nextNodes.end(), [&neighbours](int a, int b) {
+                        return neighbours[a].size() < neighbours[b].size();
+                    });
+                }
+                queue.insert(queue.end(), nextNodes.begin(), nextNodes.end());
+            }
+        }
+    }
+    return order;
+}
@@ -0,0 +1,31 @@
+#ifndef NODEREORDERING_H
+#define NODEREORDERING_H
+
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class NodeReordering
+{
+public:
+    enum Ordering {
+        reference_order,
+        breadth_first_order,
+        reverse_cuthill_mckee_order
+    };
+
+    typedef std::unordered_map<int, std::unordered_set<int>> AdjacencyMap;
+
+    virtual ~NodeReordering(){}
+
+    // returns the new id of every node. The new ids are the same set of ids, handed out again in the order given by
+    // the traversal, so neighbours in the connection graph end up with close ids.
+    static std::unordered_map<int,int> makePermutation(Ordering ordering, const std::vector<int> & ids, const AdjacencyMap & adjacency);
+
+protected:
+    static std::vector<int> breadthFirstOrder(const std::vector<std::vector<int>> & neighbours, bool minimumDegreeFirst);
+};
+
+#endif // NODEREORDERING_H
@@ -0,0 +1,110 @@
+#include "portset.h"
+
+PortSet::PortSet() :
+    lowWord(0)
+{
+
+}
+
+PortSet::~PortSet() {
+
+}
+
+void PortSet::insert(int port) throw(std::invalid_argument) {
+    if (port < 0) {
+        throw(std::invalid_argument("PortSet::insert. negative port number " + std::to_string(port)));
+    }
+
+    if (port < WORD_BITS) {
+        lowWord |= UINT64_C(1) << port;
+    } else {
+        size_t word = (port / WORD_BITS) - 1;
+        if (word >= highWords.size()) {
+            highWords.resize(word + 1, 0);
+        }
+        highWords[word] |= UINT64_C(1) << (port % WORD_BITS);
+    }
+}
+
+bool PortSet::empty() const {
+    return size() == 0;
+}
+
+int PortSet::size() const {
+    int count = popCount(lowWord);
+    for(std::uint64_t word : highWords) {
+        count += popCount(word);
+    }
+    return count;
+}
+
+std::vector<int> PortSet::toVector() const {
+    std::vector<int> ports;
+    ports.reserve(size());
+
+    for(int bit = 0; bit < WORD_BITS; bit++) {
+        if (lowWord & (UINT64_C(1) << bit)) {
+            ports.push_back(bit);
+        }
+    }
+    for(size_t word = 0; word < highWords.size(); word++) {
+        for(int bit = 0; bit < WORD_BITS; bit++) {
+            if (highWords[word] & (UINT64_C(1) << bit)) {
+                ports.push_back((word + 1) * WORD_BITS + bit);
+            }
+        }
+    }
+    return ports;
+}
+
+std::unordered_set<int> PortSet::toUnorderedSet() const {
+    std::vector<int> ports = toVector();
+    return std::unordered_set<int>(ports.begin(), ports.end());
+}
+
+size_t PortSet::hash() const {
+    std::uint64_t hashValue = lowWord * UINT64_C(0x9e3779b97f4a7c15);
+
+    size_t usedWords = highWords.size();
+    while(usedWords > 0 && highWords[usedWords - 1] == 0) {
+        usedWords--;
+    }
+    for(size_t word = 0; word < usedWords; word++) {
+        hashValue = (hashValue ^ highWords[word]) * UINT64_C(0x100000001b3);
+    }
+    return (size_t)(hashValue ^ (hashValue >> 32));
+}
+
+bool PortSet::operator==(const PortSet & other) const {
+    if (lowWord != other.lowWord) {
+        return false;
+    }
+
+    size_t maxWords = std::max(highWords.size(), other.highWords.size());
+    for(size_t word = 0; word < maxWords; word++) {
+        std::uint64_t thisWord = (word < highWords.size() ? highWords[word] : 0);
+        std::uint64_t otherWord = (word < other.highWords.size() ? other.highWords[word] : 0);
+        if (thisWord != otherWord) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PortSet::containsWide(int port) const {
+    if (port < WORD_BITS) {
+        return false;
+    }
+
+    size_t word = (port / WORD_BITS) - 1;
+    return (word < highWords.size()) && (highWords[word] & (UINT64_C(1) << (port % WORD_BITS))) != 0;
+}
+
+int PortSet::popCount(std::uint64_t word) {
+    int count = 0;
+    while(word != 0) {
+        word &= word - 1;
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,51 @@
+#ifndef PORTSET_H
+#define PORTSET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// set of pin numbers stored as a bitmask. Pins 0-63 live in a single word so a membership test is one AND,
+// wider components spill the rest of the pins into extra words.
+class PortSet
+{
+public:
+    PortSet();
+    virtual ~PortSet();
+
+    void insert(int port) throw(std::invalid_argument);
+
+    inline bool contains(int port) const {
+        if (port >= 0 && port < WORD_BITS) {
+            return (lowWord & (UINT64_C(1) << port)) != 0;
+        }
+        return containsWide(port);
+    }
+
+    bool empty() const;
+    int size() const;
+
+    std::vector<int> toVector() const;
+    std::unordered_set<int> toUnorderedSet() const;
+
+    size_t hash() const;
+
+    bool operator==(const PortSet & other) const;
+    bool operator!=(const PortSet & other) const {
+        return !(*this == other);
+    }
+
+protected:
+    static const int WORD_BITS = 64;
+
+    std::uint64_t lowWord;
+    std::vector<std::uint64_t> highWords;
+
+    bool containsWide(int port) const;
+    static int popCount(std::uint64_t word);
+};
+
+#endif // PORTSET_H
@@ -0,0 +1,233 @@
+#include "decompressingstreambuf.h"
+
+#ifdef BLOCKLYTRANSLATOR_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef BLOCKLYTRANSLATOR_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+DecompressingStreamBuf::DecompressingStreamBuf(std::istream & source, size_t chunkSize, size_t maxBytes) throw(std::invalid_argument) :
+    source(source.rdbuf()), compression(none), inBuffer(chunkSize), inBegin(0), inEnd(0), sourceEnded(false), streamEnded(false),
+    maxBytes(maxBytes), producedBytes(0)
+{
+#ifdef BLOCKLYTRANSLATOR_WITH_ZSTD
+    zstdStream = NULL;
+#endif
+
+    //the first chunk is read now so the magic bytes can be checked
+    while(inEnd < 4 && fillInput());
+    compression = detectCompression(inBuffer.data(), inEnd);
+
+    if (!isCompressionSupported(compression)) {
+        throw(std::invalid_argument("DecompressingStreamBuf. " + compressionToString(compression) +
+                                    " input but the translator was built without " + compressionToString(compression) + " support"));
+    }
+
+    if (compression == none) {
+        countProduced(inEnd);
+        setg(inBuffer.data(), inBuffer.data(), inBuffer.data() + inEnd);
+        return;
+    }
+
+    outBuffer.resize(chunkSize);
+    setg(outBuffer.data(), outBuffer.data(), outBuffer.data());
+
+#ifdef BLOCKLYTRANSLATOR_WITH_ZLIB
+    if (compression == gzip) {
+        gzipStream.reset(new z_stream());
+        if (inflateInit2(gzipStream.get(), 16 + MAX_WBITS) != Z_OK) {
+            gzipStream.reset();
+            throw(std::invalid_argument("DecompressingStreamBuf. unable to initialize zlib"));
+        }
+    }
+#endif
+#ifdef BLOCKLYTRANSLATOR_WITH_ZSTD
+    if (compression == zstd) {
+        zstdStream = ZSTD_createDStream();
+        if (zstdStream == NULL) {
+            throw(std::invalid_argument("DecompressingStreamBuf. unable to initialize zstd"));
+        }
+    }
+#endif
+}
+
+DecompressingStreamBuf::~DecompressingStreamBuf() {
+#ifdef BLOCKLYTRANSLATOR_WITH_ZLIB
+    if (gzipStream) {
+        inflateEnd(gzipStream.get());
+    }
+#endif
+#ifdef BLOCKLYTRANSLATOR_WITH_ZSTD
+    if (zstdStream != NULL) {
+        ZSTD_freeDStream(zstdStream);
+    }
+#endif
+}
+
+DecompressingStreamBuf::Compression DecompressingStreamBuf::detectCompression(const char* data, size_t size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b) {
+        return gzip;
+    } else if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd) {
+        return zstd;
+    }
+    return none;
+}
+
+bool DecompressingStreamBuf::isCompressionSupported(Compression compression) {
+    switch (compression) {
+    case gzip:
+#ifdef BLOCKLYTRANSLATOR_WITH_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case zstd:
+#ifdef BLOCKLYTRANSLATOR_WITH_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return true;
+    }
+}
+
+std::string DecompressingStreamBuf::compressionToString(Compression compression) {
+    switch (compression) {
+    case gzip:
+        return "gzip";
+    case zstd:
+        return "zstd";
+    default:
+        return "none";
+    }
+}
+
+DecompressingStreamBuf::int_type DecompressingStreamBuf::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    size_t produced = 0;
+    if (compression == none) {
+        inBegin = 0;
+        inEnd = 0;
+        if (fillInput()) {
+            produced = inEnd;
+            setg(inBuffer.data(), inBuffer.data(), inBuffer.data() + produced);
+        }
+    } else {
+        while(produced == 0 && !streamEnded) {
+            produced = (compression == gzip ? decompressGzip() : decompressZstd());
+        }
+        setg(outBuffer.data(), outBuffer.data(), outBuffer.data() + produced);
+    }
+    countProduced(produced);
+    return (produced > 0 ? traits_type::to_int_type(*gptr()) : traits_type::eof());
+}
+
+void DecompressingStreamBuf::countProduced(size_t produced) throw(std::invalid_argument) {
+    producedBytes += produced;
+    if (producedBytes > maxBytes) {
+        throw(std::invalid_argument("DecompressingStreamBuf. input larger than " + std::to_string(maxBytes) + " bytes"));
+    }
+}
+
+bool DecompressingStreamBuf::fillInput() {
+    if (sourceEnded || source == NULL) {
+        sourceEnded = true;
+        return false;
+    }
+
+    if (inBegin > 0) {
+        std::copy(inBuffer.begin() + inBegin, inBuffer.begin() + inEnd, inBuffer.begin());
+        inEnd -= inBegin;
+        inBegin = 0;
+    }
+
+    std::streamsize readed = source->sgetn(inBuffer.data() + inEnd, inBuffer.size() - inEnd);
+    if (readed <= 0) {
+        sourceEnded = true;
+        return false;
+    }
+    inEnd += readed;
+    return true;
+}
+
+size_t DecompressingStreamBuf::decompressGzip() throw(std::invalid_argument) {
+#ifdef BLOCKLYTRANSLATOR_WITH_ZLIB
+    if (inBegin == inEnd) {
+        fillInput();
+    }
+
+    gzipStream->next_in = reinterpret_cast<Bytef*>(inBuffer.data() + inBegin);
+    gzipStream->avail_in = inEnd - inBegin;
+    gzipStream->next_out = reinterpret_cast<Bytef*>(outBuffer.data());
+    gzipStream->avail_out = outBuffer.size();
+
+    int result = inflate(gzipStream.get(), Z_NO_FLUSH);
+    if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+        throw(std::invalid_argument("DecompressingStreamBuf. gzip error: " +
+                                    std::string(gzipStream->msg != NULL ? gzipStream->msg : "corrupted input")));
+    }
+
+    inBegin = inEnd - gzipStream->avail_in;
+    size_t produced = outBuffer.size() - gzipStream->avail_out;
+    if (result != Z_STREAM_END && produced == 0 && inBegin == inEnd && sourceEnded) {
+        throw(std::invalid_argument("DecompressingStreamBuf. truncated gzip input"));
+    }
+
+    if (result == Z_STREAM_END) {
+        //concatenated gzip members are read as a single stream
+        if (inBegin == inEnd && !fillInput()) {
+            streamEnded = true;
+        } else {
+            inflateReset(gzipStream.get());
+        }
+    }
+    return produced;
+#else
+    throw(std::invalid_argument("DecompressingStreamBuf. gzip support not available"));
+#endif
+}
+
+size_t DecompressingStreamBuf::decompressZstd() throw(std::invalid_argument) {
+#ifdef BLOCKLYTRANSLATOR_WITH_ZSTD
+    if (inBegin == inEnd) {
+        fillInput();
+    }
+
+    ZSTD_inBuffer input = {inBuffer.data(), inEnd, inBegin};
+    ZSTD_outBuffer output = {outBuffer.data(), outBuffer.size(), 0};
+
+    size_t result = ZSTD_decompressStream(zstdStream, &output, &input);
+    if (ZSTD_isError(result)) {
+        throw(std::invalid_argument("DecompressingStreamBuf. zstd error: " + std::string(ZSTD_getErrorName(result))));
+    }
+    inBegin = input.pos;
+    if (result != 0 && output.pos == 0 && inBegin == inEnd && sourceEnded) {
+        throw(std::invalid_argument("DecompressingStreamBuf. truncated zstd input"));
+    }
+
+    //0 means a frame has been completely decoded, following frames are read as part of the same stream
+    if (result == 0 && inBegin == inEnd && !fillInput()) {
+        streamEnded = true;
+    }
+    return output.pos;
+#else
+    throw(std::invalid_argument("DecompressingStreamBuf. zstd support not available"));
+#endif
+}
+
+DecompressingInputStream::DecompressingInputStream(std::istream & source, size_t maxBytes) throw(std::invalid_argument) :
+    std::istream(NULL), buffer(source, 64 * 1024, maxBytes)
+{
+    rdbuf(&buffer);
+    exceptions(std::ios::badbit);
+}
+
+DecompressingInputStream::~DecompressingInputStream() {
+
+}
@@ -0,0 +1,93 @@
+#ifndef DECOMPRESSINGSTREAMBUF_H
+#define DECOMPRESSINGSTREAMBUF_H
+
+#include <algorithm>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#ifdef BLOCKLYTRANSLATOR_WITH_ZLIB
+struct z_stream_s;
+#endif
+#ifdef BLOCKLYTRANSLATOR_WITH_ZSTD
+struct ZSTD_DCtx_s;
+#endif
+
+// reads the source stream in fixed size chunks and hands out its contents decompressed. The compression is detected
+// from the magic bytes at the start of the source: gzip needs BLOCKLYTRANSLATOR_WITH_ZLIB (CONFIG += gzip) and zstd
+// BLOCKLYTRANSLATOR_WITH_ZSTD (CONFIG += zstd); anything else is passed through untouched. Only the two chunks are
+// kept in memory whatever the size of the input. Reading more than maxBytes of decompressed data throws, so a
+// compression bomb stops after maxBytes.
+class DecompressingStreamBuf : public std::streambuf
+{
+public:
+    typedef enum Compression_ {
+        none,
+        gzip,
+        zstd
+    } Compression;
+
+    DecompressingStreamBuf(std::istream & source,
+                           size_t chunkSize = 64 * 1024,
+                           size_t maxBytes = std::numeric_limits<size_t>::max()) throw(std::invalid_argument);
+    virtual ~DecompressingStreamBuf();
+
+    Compression getCompression() const {
+        return compression;
+    }
+
+    static Compression detectCompression(const char* data, size_t size);
+    static bool isCompressionSupported(Compression compression);
+    static std::string compressionToString(Compression compression);
+
+protected:
+    std::streambuf* source;
+    Compression compression;
+
+    std::vector<char> inBuffer;
+    size_t inBegin;
+    size_t inEnd;
+    bool sourceEnded;
+    bool streamEnded;
+
+    std::vector<char> outBuffer;
+
+    size_t maxBytes;
+    size_t producedBytes;
+
+#ifdef BLOCKLYTRANSLATOR_WITH_ZLIB
+    std::unique_ptr<z_stream_s> gzipStream;
+#endif
+#ifdef BLOCKLYTRANSLATOR_WITH_ZSTD
+    ZSTD_DCtx_s* zstdStream;
+#endif
+
+    virtual int_type underflow();
+
+    bool fillInput();
+    void countProduced(size_t produced) throw(std::invalid_argument);
+    size_t decompressGzip() throw(std::invalid_argument);
+    size_t decompressZstd() throw(std::invalid_argument);
+};
+
+// istream over a DecompressingStreamBuf. Decompression errors are rethrown by the reading operations instead of only
+// setting the badbit.
+class DecompressingInputStream : public std::istream
+{
+public:
+    DecompressingInputStream(std::istream & source, size_t maxBytes = std::numeric_limits<size_t>::max()) throw(std::invalid_argument);
+    virtual ~DecompressingInputStream();
+
+    DecompressingStreamBuf::Compression getCompression() const {
+        return buffer.getCompression();
+    }
+
+protected:
+    DecompressingStreamBuf buffer;
+};
+
+#endif // DECOMPRESSINGSTREAMBUF_H
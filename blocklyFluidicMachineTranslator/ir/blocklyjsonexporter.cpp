@@ -0,0 +1,205 @@
+#include "blocklyjsonexporter.h"
+
+const std::string BlocklyJsonExporter::PART_COPY_STR = "part_copy";
+const int BlocklyJsonExporter::MAX_COPY_LEVEL = 9;
+//indexed by MachineIR::NodeKind
+const char * const BlocklyJsonExporter::NODE_TYPES[] = {"OPEN_CONTAINER", "CLOSE_CONTAINER", "PUMP", "VALVE"};
+
+void BlocklyJsonExporter::write(const MachineIR & ir, std::ostream & out) throw(std::invalid_argument) {
+    write(ir, out, false);
+}
+
+void BlocklyJsonExporter::writeLineDelimited(const MachineIR & ir, std::ostream & out) throw(std::invalid_argument) {
+    write(ir, out, true);
+}
+
+void BlocklyJsonExporter::writeFile(const MachineIR & ir, const std::string & path) throw(std::invalid_argument) {
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw(std::invalid_argument("BlocklyJsonExporter::writeFile. unable to open " + path));
+    }
+    write(ir, out, false);
+}
+
+std::string BlocklyJsonExporter::toString(const MachineIR & ir) throw(std::invalid_argument) {
+    std::ostringstream out;
+    write(ir, out, false);
+    return out.str();
+}
+
+void BlocklyJsonExporter::write(const MachineIR & ir, std::ostream & out, bool lineDelimited) throw(std::invalid_argument) {
+    BLOCKLY_TRACE_SPAN(span, "BlocklyJsonExporter::write");
+    BLOCKLY_TRACE_ARG(span, "nodes", ir.getNodes().size());
+    try {
+        PinTargets pinTargets = makePinTargets(ir);
+        std::vector<std::string> descriptorsJson(ir.getDescriptors().size());
+
+        out << "{";
+        writeHeaderFields(ir.getHeader(), out);
+        if (lineDelimited) {
+            out << ",\"number_blocks\":" << ir.getNodes().size() << "}\n";
+        } else {
+            out << ",\"connections\":[";
+        }
+
+        for(size_t i = 0; i < ir.getNodes().size(); i++) {
+            if (!lineDelimited && i > 0) {
+                out << ",";
+            }
+            writeBlock(ir, i, pinTargets, descriptorsJson, out);
+            if (lineDelimited) {
+                out << "\n";
+            }
+        }
+
+        if (!lineDelimited) {
+            out << "]}";
+        }
+        if (!out) {
+            throw(std::invalid_argument("error writing the output"));
+        }
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("BlocklyJsonExporter::write. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+BlocklyJsonExporter::PinTargets BlocklyJsonExporter::makePinTargets(const MachineIR & ir) throw(std::invalid_argument) {
+    const std::vector<MachineIR::Node> & nodes = ir.getNodes();
+
+    PinTargets pinTargets;
+    pinTargets.targets.assign(ir.getPortDirections().size(), -1);
+    pinTargets.copyLevels.assign(ir.getPortDirections().size(), 0);
+    pinTargets.twins.resize(nodes.size());
+
+    //the n-th edge between the same two nodes is written with n part copies at both ends, so their keys differ
+    std::unordered_map<uint64_t, int> edgesBetween;
+    for(const MachineIR::Edge & edge : ir.getEdges()) {
+        const MachineIR::Node & source = nodes[ir.getNodeIndex(edge.source)];
+        const MachineIR::Node & target = nodes[ir.getNodeIndex(edge.target)];
+        if (edge.sourcePort < 0 || static_cast<uint32_t>(edge.sourcePort) >= source.pins ||
+            edge.targetPort < 0 || static_cast<uint32_t>(edge.targetPort) >= target.pins)
+        {
+            throw(std::invalid_argument("edge " + std::to_string(edge.source) + "-" + std::to_string(edge.target) +
+                                        " out of the pins of its nodes"));
+        }
+
+        uint64_t pairKey = (static_cast<uint64_t>(static_cast<uint32_t>(std::min(edge.source, edge.target))) << 32) |
+                           static_cast<uint32_t>(std::max(edge.source, edge.target));
+        int copyLevel = edgesBetween[pairKey]++;
+        if (copyLevel > MAX_COPY_LEVEL) {
+            throw(std::invalid_argument("BlocklyJsonExporter::makePinTargets. nodes " + std::to_string(edge.source) +
+                                        " and " + std::to_string(edge.target) + " are joined by more than " +
+                                        std::to_string(MAX_COPY_LEVEL + 1) + " edges, the Blockly JSON can not " +
+                                        "nest more than " + std::to_string(MAX_COPY_LEVEL) + " part copies"));
+        }
+
+        size_t sourcePin = source.firstPort + edge.sourcePort;
+        size_t targetPin = target.firstPort + edge.targetPort;
+        pinTargets.targets[sourcePin] = edge.target;
+        pinTargets.copyLevels[sourcePin] = copyLevel;
+        pinTargets.targets[targetPin] = edge.source;
+        pinTargets.copyLevels[targetPin] = copyLevel;
+    }
+
+    //every group is written in the block of its first valve
+    const std::vector<uint32_t> & offsets = ir.getTwinOffsets();
+    const std::vector<int> & members = ir.getTwinMembers();
+    for(size_t i = 0; i < ir.getTwinGroupsNumber(); i++) {
+        if (offsets[i] == offsets[i+1]) {
+            continue;
+        }
+        std::vector<int> & twins = pinTargets.twins[ir.getNodeIndex(members[offsets[i]])];
+        twins.insert(twins.end(), members.begin() + offsets[i] + 1, members.begin() + offsets[i+1]);
+    }
+    return pinTargets;
+}
+
+void BlocklyJsonExporter::writeHeaderFields(const MachineIR::Header & header, std::ostream & out) {
+    out << "\"default_rate\":" << nlohmann::json(header.defaultRate).dump()
+        << ",\"default_rate_volume_units\":" << quote(header.rateVolumeUnits)
+        << ",\"default_rate_time_units\":" << quote(header.rateTimeUnits)
+        << ",\"integer_precission\":" << header.integerPrecission
+        << ",\"decimal_precission\":" << header.decimalPrecission;
+}
+
+void BlocklyJsonExporter::writeBlock(
+        const MachineIR & ir,
+        size_t nodeIndex,
+        const PinTargets & pinTargets,
+        std::vector<std::string> & descriptorsJson,
+        std::ostream & out)
+    throw(std::invalid_argument)
+{
+    const MachineIR::Node & node = ir.getNodes()[nodeIndex];
+
+    out << "{\"reference\":" << quote(ir.getReferences().at(node.reference))
+        << ",\"type\":\"" << NODE_TYPES[node.kind] << "\""
+        << ",\"functions\":" << getDescriptorJson(ir, node.functions, descriptorsJson);
+    if (node.extraFunctions != MachineIR::NO_DESCRIPTOR) {
+        out << ",\"extra_functions\":" << getDescriptorJson(ir, node.extraFunctions, descriptorsJson);
+    }
+    out << ",\"number_pins\":" << node.pins;
+
+    for(int direction = MachineIR::in_port; direction <= MachineIR::out_port; direction++) {
+        out << (direction == MachineIR::in_port ? ",\"in_ports\":[" : ",\"out_ports\":[");
+        bool first = true;
+        for(uint32_t pin = 0; pin < node.pins; pin++) {
+            if (ir.getPortDirection(node, pin) == direction) {
+                out << (first ? "" : ",") << (pin + 1);
+                first = false;
+            }
+        }
+        out << "]";
+    }
+
+    for(uint32_t pin = 0; pin < node.pins; pin++) {
+        int target = pinTargets.targets[node.firstPort + pin];
+        if (target < 0) {
+            throw(std::invalid_argument("pin " + std::to_string(pin + 1) + " of node " + std::to_string(node.id) +
+                                        " is not connected"));
+        }
+        out << ",\"port" << (pin + 1) << "\":";
+        writeReference(ir, target, pinTargets.copyLevels[node.firstPort + pin], out);
+    }
+
+    const std::vector<int> & twins = pinTargets.twins[nodeIndex];
+    if (!twins.empty()) {
+        out << ",\"number_twins\":" << twins.size();
+        for(size_t i = 0; i < twins.size(); i++) {
+            out << ",\"twin" << (i + 1) << "\":";
+            writeReference(ir, twins[i], 0, out);
+        }
+    }
+    out << "}";
+}
+
+void BlocklyJsonExporter::writeReference(const MachineIR & ir, int id, int copyLevel, std::ostream & out)
+    throw(std::invalid_argument)
+{
+    const MachineIR::Node & node = ir.getNodes()[ir.getNodeIndex(id)];
+    for(int i = 0; i < copyLevel; i++) {
+        out << "{\"block_type\":\"" << PART_COPY_STR << "\",\"reference\":";
+    }
+    out << "{\"reference\":" << quote(ir.getReferences().at(node.reference)) << "}";
+    for(int i = 0; i < copyLevel; i++) {
+        out << "}";
+    }
+}
+
+const std::string & BlocklyJsonExporter::getDescriptorJson(
+        const MachineIR & ir,
+        uint32_t descriptor,
+        std::vector<std::string> & descriptorsJson)
+    throw(std::invalid_argument)
+{
+    //every descriptor is decoded once, the blocks sharing it write the same text
+    std::string & descriptorJson = descriptorsJson.at(descriptor);
+    if (descriptorJson.empty()) {
+        descriptorJson = ir.getDescriptorJson(descriptor).dump();
+    }
+    return descriptorJson;
+}
+
+std::string BlocklyJsonExporter::quote(const std::string & value) {
+    return nlohmann::json(value).dump();
+}
@@ -0,0 +1,61 @@
+#ifndef BLOCKLYJSONEXPORTER_H
+#define BLOCKLYJSONEXPORTER_H
+
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <json.hpp>
+
+#include "blocklyFluidicMachineTranslator/ir/machineir.h"
+#include "blocklyFluidicMachineTranslator/tracing/tracer.h"
+
+// writes a MachineIR back as the Blockly JSON read by the translator, block by block straight to the stream without
+// building the document. The blocks keep the references of the IR; when two nodes are joined by more than one edge the
+// extra edges are written as part_copy references so the ports still pair up. writeLineDelimited() writes the line
+// delimited format of translateLineDelimitedFile().
+class BlocklyJsonExporter
+{
+public:
+    virtual ~BlocklyJsonExporter(){}
+
+    static void write(const MachineIR & ir, std::ostream & out) throw(std::invalid_argument);
+    static void writeLineDelimited(const MachineIR & ir, std::ostream & out) throw(std::invalid_argument);
+
+    static void writeFile(const MachineIR & ir, const std::string & path) throw(std::invalid_argument);
+    static std::string toString(const MachineIR & ir) throw(std::invalid_argument);
+
+protected:
+    static const std::string PART_COPY_STR;
+    static const char * const NODE_TYPES[];
+    // the nested part copies BlocklyFluidicMachineTranslator reads, the same as its MAX_COPY_LEVEL
+    static const int MAX_COPY_LEVEL;
+
+    // per pin of the IR (same positions as getPortDirections()) the node it is connected to and the copy level
+    struct PinTargets {
+        std::vector<int> targets;
+        std::vector<int> copyLevels;
+        std::vector<std::vector<int>> twins;
+    };
+
+    static void write(const MachineIR & ir, std::ostream & out, bool lineDelimited) throw(std::invalid_argument);
+    static PinTargets makePinTargets(const MachineIR & ir) throw(std::invalid_argument);
+
+    static void writeHeaderFields(const MachineIR::Header & header, std::ostream & out);
+    static void writeBlock(const MachineIR & ir,
+                           size_t nodeIndex,
+                           const PinTargets & pinTargets,
+                           std::vector<std::string> & descriptorsJson,
+                           std::ostream & out) throw(std::invalid_argument);
+    static void writeReference(const MachineIR & ir, int id, int copyLevel, std::ostream & out) throw(std::invalid_argument);
+    static const std::string & getDescriptorJson(const MachineIR & ir,
+                                                 uint32_t descriptor,
+                                                 std::vector<std::string> & descriptorsJson) throw(std::invalid_argument);
+    static std::string quote(const std::string & value);
+};
+
+#endif // BLOCKLYJSONEXPORTER_H
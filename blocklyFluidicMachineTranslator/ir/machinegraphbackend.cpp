@@ -0,0 +1,174 @@
+#include "machinegraphbackend.h"
+
+std::shared_ptr<MachineGraph> MachineGraphBackEnd::lower(
+        const MachineIR & ir,
+        std::shared_ptr<PluginAbstractFactory> factory,
+        std::shared_ptr<DeferredFunctionsStore> deferredFunctions)
+    throw(std::invalid_argument)
+{
+    BLOCKLY_TRACE_SPAN(span, "MachineGraphBackEnd::lower");
+    BLOCKLY_TRACE_ARG(span, "nodes", ir.getNodes().size());
+    try {
+        Lowering lowering(ir, factory, deferredFunctions);
+        std::shared_ptr<MachineGraph> graph = std::make_shared<MachineGraph>();
+
+        for(const MachineIR::Node & node : ir.getNodes()) {
+            NodePayload payload = prepareNode(lowering, node, !deferredFunctions);
+            std::shared_ptr<ContainerNode> container = addNode(node, payload, *graph);
+
+            if (container && deferredFunctions && node.extraFunctions != MachineIR::NO_DESCRIPTOR) {
+                //the descriptors of the IR are already the compact form the store keeps
+                deferredFunctions->defer(node.id, container, ir.getDescriptors().at(node.extraFunctions));
+            }
+        }
+        addConnections(ir, *graph);
+        return graph;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("MachineGraphBackEnd::lower. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+std::vector<MachineGraphBackEnd::NodePayload> MachineGraphBackEnd::prepare(
+        const MachineIR & ir,
+        std::shared_ptr<PluginAbstractFactory> factory)
+    throw(std::invalid_argument)
+{
+    BLOCKLY_TRACE_SPAN(span, "MachineGraphBackEnd::prepare");
+    try {
+        Lowering lowering(ir, factory, std::shared_ptr<DeferredFunctionsStore>());
+
+        std::vector<NodePayload> payloads;
+        payloads.reserve(ir.getNodes().size());
+        for(const MachineIR::Node & node : ir.getNodes()) {
+            payloads.push_back(prepareNode(lowering, node, true));
+        }
+        return payloads;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("MachineGraphBackEnd::prepare. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+std::shared_ptr<MachineGraph> MachineGraphBackEnd::instantiate(const MachineIR & ir, const std::vector<NodePayload> & payloads)
+    throw(std::invalid_argument)
+{
+    BLOCKLY_TRACE_SPAN(span, "MachineGraphBackEnd::instantiate");
+    try {
+        const std::vector<MachineIR::Node> & nodes = ir.getNodes();
+        if (payloads.size() != nodes.size()) {
+            throw(std::invalid_argument("the payloads are not the ones of the IR"));
+        }
+
+        std::shared_ptr<MachineGraph> graph = std::make_shared<MachineGraph>();
+        for(size_t i = 0; i < nodes.size(); i++) {
+            addNode(nodes[i], payloads[i], *graph);
+        }
+        addConnections(ir, *graph);
+        return graph;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("MachineGraphBackEnd::instantiate. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+MachineGraphBackEnd::NodePayload MachineGraphBackEnd::prepareNode(
+        Lowering & lowering,
+        const MachineIR::Node & node,
+        bool withExtraFunctions)
+    throw(std::invalid_argument)
+{
+    NodePayload payload;
+    units::Volume minVolume;
+
+    switch (node.kind) {
+    case MachineIR::open_container_node:
+        FunctionsdBlocksTranslator::processOpenGlasswareFunction(lowering.getDescriptor(node.functions), minVolume, payload.capacity);
+        break;
+    case MachineIR::close_container_node:
+        FunctionsdBlocksTranslator::processCloseGlasswareFunction(lowering.getDescriptor(node.functions), minVolume, payload.capacity);
+        break;
+    case MachineIR::pump_node:
+        payload.pump = FunctionsdBlocksTranslator::processPumpFunction(lowering.getDescriptor(node.functions),
+                                                                       payload.reversible,
+                                                                       lowering.factory,
+                                                                       lowering.functionCache);
+        break;
+    case MachineIR::valve_node:
+        payload.valve = FunctionsdBlocksTranslator::processValveFunction(lowering.getDescriptor(node.functions),
+                                                                         node.pins,
+                                                                         lowering.truthTableCache,
+                                                                         payload.truthTable,
+                                                                         lowering.factory,
+                                                                         lowering.functionCache);
+        break;
+    default:
+        throw(std::invalid_argument("unknow node kind " + std::to_string(node.kind) + " of node " + std::to_string(node.id)));
+    }
+
+    bool isContainer = (node.kind == MachineIR::open_container_node || node.kind == MachineIR::close_container_node);
+    if (isContainer && withExtraFunctions && node.extraFunctions != MachineIR::NO_DESCRIPTOR) {
+        payload.extraFunctions = FunctionsdBlocksTranslator::processFunctions(lowering.getDescriptor(node.extraFunctions),
+                                                                              lowering.factory,
+                                                                              lowering.functionCache);
+    }
+    return payload;
+}
+
+std::shared_ptr<ContainerNode> MachineGraphBackEnd::addNode(
+        const MachineIR::Node & node,
+        const NodePayload & payload,
+        MachineGraph & graph)
+    throw(std::invalid_argument)
+{
+    switch (node.kind) {
+    case MachineIR::open_container_node:
+    case MachineIR::close_container_node: {
+        std::shared_ptr<ContainerNode> nodePtr =
+                std::make_shared<ContainerNode>(node.id,
+                                                node.pins,
+                                                node.kind == MachineIR::open_container_node ? ContainerNode::open : ContainerNode::close,
+                                                payload.capacity);
+        for(auto func : payload.extraFunctions) {
+            nodePtr->addOperation(func);
+        }
+        graph.addNode(nodePtr);
+        return nodePtr;
+    }
+    case MachineIR::pump_node:
+        graph.addNode(std::make_shared<PumpNode>(node.id,
+                                                 node.pins,
+                                                 payload.reversible ? PumpNode::bidirectional : PumpNode::unidirectional,
+                                                 payload.pump));
+        return std::shared_ptr<ContainerNode>();
+    case MachineIR::valve_node:
+        if (!payload.truthTable) {
+            throw(std::invalid_argument("missing truth table of node " + std::to_string(node.id)));
+        }
+        graph.addNode(std::make_shared<ValveNode>(node.id, node.pins, *payload.truthTable, payload.valve));
+        return std::shared_ptr<ContainerNode>();
+    default:
+        throw(std::invalid_argument("unknow node kind " + std::to_string(node.kind) + " of node " + std::to_string(node.id)));
+    }
+}
+
+void MachineGraphBackEnd::addConnections(const MachineIR & ir, MachineGraph & graph) {
+    for(const MachineIR::Edge & edge : ir.getEdges()) {
+        graph.connectNodes(edge.source, edge.target, edge.sourcePort, edge.targetPort);
+    }
+
+    const std::vector<uint32_t> & offsets = ir.getTwinOffsets();
+    const std::vector<int> & members = ir.getTwinMembers();
+    for(size_t i = 0; i < ir.getTwinGroupsNumber(); i++) {
+        std::unordered_set<int> twins(members.begin() + offsets[i], members.begin() + offsets[i+1]);
+        graph.setValvesAsTwins(twins);
+    }
+}
+
+const nlohmann::json & MachineGraphBackEnd::Lowering::getDescriptor(uint32_t descriptor) throw(std::invalid_argument) {
+    if (descriptor >= decoded.size()) {
+        throw(std::invalid_argument("unknow descriptor " + std::to_string(descriptor)));
+    }
+    if (!isDecoded[descriptor]) {
+        decoded[descriptor] = ir.getDescriptorJson(descriptor);
+        isDecoded[descriptor] = true;
+    }
+    return decoded[descriptor];
+}
@@ -0,0 +1,86 @@
+#ifndef MACHINEGRAPHBACKEND_H
+#define MACHINEGRAPHBACKEND_H
+
+#include <memory>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include <json.hpp>
+
+#include <commonmodel/functions/function.h>
+#include <commonmodel/functions/pumppluginfunction.h>
+#include <commonmodel/functions/valvepluginroutefunction.h>
+
+#include <fluidicmachinemodel/machinegraph.h>
+#include <fluidicmachinemodel/fluidicnode/containernode.h>
+#include <fluidicmachinemodel/fluidicnode/pumpnode.h>
+#include <fluidicmachinemodel/fluidicnode/valvenode.h>
+
+#include "blocklyFluidicMachineTranslator/blocks/deferredfunctionsstore.h"
+#include "blocklyFluidicMachineTranslator/blocks/functionsdblockstranslator.h"
+#include "blocklyFluidicMachineTranslator/blocks/pluginfunctioncache.h"
+#include "blocklyFluidicMachineTranslator/blocks/truthtablecache.h"
+#include "blocklyFluidicMachineTranslator/ir/machineir.h"
+#include "blocklyFluidicMachineTranslator/tracing/tracer.h"
+
+// lowers a MachineIR to a MachineGraph. Every descriptor is decoded and built once no matter how many nodes share it.
+// With a DeferredFunctionsStore the extra functions of the containers are deferred to it instead of being built.
+// prepare() and instantiate() split the lowering in the building of the functions and the creation of the nodes, so
+// the prepared functions can be shared by several graphs of the same IR.
+class MachineGraphBackEnd
+{
+public:
+    // immutable functions of a node, shared by every graph instantiated from them
+    struct NodePayload {
+        std::shared_ptr<PumpPluginFunction> pump;
+        bool reversible;
+        std::shared_ptr<ValvePluginRouteFunction> valve;
+        TruthTableCache::TruthTablePtr truthTable;
+        units::Volume capacity;
+        std::vector<std::shared_ptr<Function>> extraFunctions;
+
+        NodePayload() :
+            reversible(false)
+        {}
+    };
+
+    virtual ~MachineGraphBackEnd(){}
+
+    static std::shared_ptr<MachineGraph> lower(
+            const MachineIR & ir,
+            std::shared_ptr<PluginAbstractFactory> factory,
+            std::shared_ptr<DeferredFunctionsStore> deferredFunctions = std::shared_ptr<DeferredFunctionsStore>()) throw(std::invalid_argument);
+
+    // one payload per node of the IR, in the same order
+    static std::vector<NodePayload> prepare(const MachineIR & ir, std::shared_ptr<PluginAbstractFactory> factory) throw(std::invalid_argument);
+    static std::shared_ptr<MachineGraph> instantiate(const MachineIR & ir, const std::vector<NodePayload> & payloads) throw(std::invalid_argument);
+
+protected:
+    struct Lowering {
+        const MachineIR & ir;
+        std::shared_ptr<PluginAbstractFactory> factory;
+        std::shared_ptr<DeferredFunctionsStore> deferredFunctions;
+
+        TruthTableCache truthTableCache;
+        PluginFunctionCache functionCache;
+        std::vector<nlohmann::json> decoded;
+        std::vector<bool> isDecoded;
+
+        Lowering(const MachineIR & ir,
+                 std::shared_ptr<PluginAbstractFactory> factory,
+                 std::shared_ptr<DeferredFunctionsStore> deferredFunctions) :
+            ir(ir), factory(factory), deferredFunctions(deferredFunctions),
+            decoded(ir.getDescriptors().size()), isDecoded(ir.getDescriptors().size(), false)
+        {}
+
+        const nlohmann::json & getDescriptor(uint32_t descriptor) throw(std::invalid_argument);
+    };
+
+    static NodePayload prepareNode(Lowering & lowering, const MachineIR::Node & node, bool withExtraFunctions) throw(std::invalid_argument);
+    static std::shared_ptr<ContainerNode> addNode(const MachineIR::Node & node, const NodePayload & payload, MachineGraph & graph)
+        throw(std::invalid_argument);
+    static void addConnections(const MachineIR & ir, MachineGraph & graph);
+};
+
+#endif // MACHINEGRAPHBACKEND_H
@@ -0,0 +1,114 @@
+#include "machineir.h"
+
+const uint32_t MachineIR::NO_DESCRIPTOR = UINT32_MAX;
+
+MachineIR::MachineIR() :
+    twinOffsets(1, 0)
+{
+
+}
+
+MachineIR::~MachineIR() {
+
+}
+
+void MachineIR::addNode(
+        int id,
+        NodeKind kind,
+        uint32_t pins,
+        const PortSet & inPorts,
+        const PortSet & outPorts,
+        uint32_t functions,
+        uint32_t extraFunctions,
+        const std::string & reference)
+    throw(std::invalid_argument)
+{
+    if (!nodes.empty() && nodes.back().id >= id) {
+        throw(std::invalid_argument("MachineIR::addNode. node " + std::to_string(id) + " added out of order"));
+    }
+
+    Node node;
+    node.id = id;
+    node.kind = static_cast<uint8_t>(kind);
+    node.pins = pins;
+    node.firstPort = portDirections.size();
+    node.functions = functions;
+    node.extraFunctions = extraFunctions;
+    node.reference = references.size();
+    nodes.push_back(node);
+
+    for(uint32_t pin = 0; pin < pins; pin++) {
+        if (inPorts.contains(pin)) {
+            portDirections.push_back(in_port);
+        } else if (outPorts.contains(pin)) {
+            portDirections.push_back(out_port);
+        } else {
+            portDirections.push_back(undirected_port);
+        }
+    }
+    references.push_back(reference);
+}
+
+void MachineIR::addEdge(int source, int target, int sourcePort, int targetPort) {
+    Edge edge;
+    edge.source = source;
+    edge.target = target;
+    edge.sourcePort = sourcePort;
+    edge.targetPort = targetPort;
+    edges.push_back(edge);
+}
+
+void MachineIR::addTwins(const std::unordered_set<int> & twins) {
+    //sorted so the same machine always gives the same arrays
+    std::vector<int> sortedTwins(twins.begin(), twins.end());
+    std::sort(sortedTwins.begin(), sortedTwins.end());
+
+    twinMembers.insert(twinMembers.end(), sortedTwins.begin(), sortedTwins.end());
+    twinOffsets.push_back(twinMembers.size());
+}
+
+uint32_t MachineIR::internDescriptor(const nlohmann::json & functionsObj) {
+    return internDescriptor(nlohmann::json::to_cbor(functionsObj));
+}
+
+uint32_t MachineIR::internDescriptor(const Descriptor & descriptor) {
+    std::string key(descriptor.begin(), descriptor.end());
+
+    auto finded = descriptorsIndex.find(key);
+    if (finded != descriptorsIndex.end()) {
+        return finded->second;
+    }
+
+    uint32_t index = descriptors.size();
+    descriptors.push_back(descriptor);
+    descriptorsIndex.insert(std::make_pair(key, index));
+    return index;
+}
+
+size_t MachineIR::getNodeIndex(int id) const throw(std::invalid_argument) {
+    //dense ids are their own index, otherwise binary search over the sorted nodes
+    if (id >= 0 && static_cast<size_t>(id) < nodes.size() && nodes[id].id == id) {
+        return id;
+    }
+
+    auto finded = std::lower_bound(nodes.begin(), nodes.end(), id, [](const Node & node, int id) {
+        return node.id < id;
+    });
+    if (finded == nodes.end() || finded->id != id) {
+        throw(std::invalid_argument("MachineIR::getNodeIndex. unknow node " + std::to_string(id)));
+    }
+    return finded - nodes.begin();
+}
+
+nlohmann::json MachineIR::getDescriptorJson(uint32_t descriptor) const throw(std::invalid_argument) {
+    if (descriptor >= descriptors.size()) {
+        throw(std::invalid_argument("MachineIR::getDescriptorJson. unknow descriptor " + std::to_string(descriptor)));
+    }
+    return nlohmann::json::from_cbor(descriptors[descriptor]);
+}
+
+void MachineIR::reserve(size_t nodesNumber, size_t edgesNumber) {
+    nodes.reserve(nodesNumber);
+    references.reserve(nodesNumber);
+    edges.reserve(edgesNumber);
+}
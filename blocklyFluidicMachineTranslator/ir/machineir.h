@@ -0,0 +1,147 @@
+#ifndef MACHINEIR_H
+#define MACHINEIR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <json.hpp>
+
+#include "blocklyFluidicMachineTranslator/graph/portset.h"
+
+// flat intermediate representation of a machine between the Blockly JSON and the MachineGraph. Everything is kept in
+// contiguous arrays indexed by dense ids: the nodes sorted by id, the directions of their pins, the edges, the valve
+// twin groups and the function descriptors (CBOR) deduplicated so identical blocks share one. The translator fills it,
+// MachineGraphBackEnd lowers it to a MachineGraph and MachineIRImage writes it as a binary image.
+class MachineIR
+{
+public:
+    static const uint32_t NO_DESCRIPTOR;
+
+    enum NodeKind {
+        open_container_node = 0,
+        close_container_node = 1,
+        pump_node = 2,
+        valve_node = 3
+    };
+
+    enum PortDirection {
+        undirected_port = 0,
+        in_port = 1,
+        out_port = 2
+    };
+
+    struct Header {
+        double defaultRate;
+        std::string rateVolumeUnits;
+        std::string rateTimeUnits;
+        int integerPrecission;
+        int decimalPrecission;
+
+        Header() :
+            defaultRate(0), integerPrecission(0), decimalPrecission(0)
+        {}
+    };
+
+    struct Node {
+        int id;
+        uint8_t kind;
+        uint32_t pins;
+        uint32_t firstPort;
+        uint32_t functions;
+        uint32_t extraFunctions;
+        uint32_t reference;
+    };
+
+    struct Edge {
+        int source;
+        int target;
+        int sourcePort;
+        int targetPort;
+    };
+
+    typedef std::vector<uint8_t> Descriptor;
+
+    MachineIR();
+    virtual ~MachineIR();
+
+    // nodes must be added in increasing id order, the pins of the node are taken from the direction sets
+    void addNode(int id,
+                 NodeKind kind,
+                 uint32_t pins,
+                 const PortSet & inPorts,
+                 const PortSet & outPorts,
+                 uint32_t functions,
+                 uint32_t extraFunctions,
+                 const std::string & reference) throw(std::invalid_argument);
+    void addEdge(int source, int target, int sourcePort, int targetPort);
+    void addTwins(const std::unordered_set<int> & twins);
+
+    // index of the descriptor of functionsObj, the same index for equal objects
+    uint32_t internDescriptor(const nlohmann::json & functionsObj);
+    uint32_t internDescriptor(const Descriptor & descriptor);
+
+    // position of the node in getNodes(), the id itself when the ids are dense
+    size_t getNodeIndex(int id) const throw(std::invalid_argument);
+    nlohmann::json getDescriptorJson(uint32_t descriptor) const throw(std::invalid_argument);
+
+    inline PortDirection getPortDirection(const Node & node, uint32_t pin) const {
+        return static_cast<PortDirection>(portDirections[node.firstPort + pin]);
+    }
+
+    inline const Header & getHeader() const {
+        return header;
+    }
+    inline void setHeader(const Header & header) {
+        this->header = header;
+    }
+
+    inline const std::vector<Node> & getNodes() const {
+        return nodes;
+    }
+    inline const std::vector<uint8_t> & getPortDirections() const {
+        return portDirections;
+    }
+    inline const std::vector<Edge> & getEdges() const {
+        return edges;
+    }
+    // the members of group i are getTwinMembers()[getTwinOffsets()[i] .. getTwinOffsets()[i+1]]
+    inline const std::vector<uint32_t> & getTwinOffsets() const {
+        return twinOffsets;
+    }
+    inline const std::vector<int> & getTwinMembers() const {
+        return twinMembers;
+    }
+    inline size_t getTwinGroupsNumber() const {
+        return twinOffsets.size() - 1;
+    }
+    inline const std::vector<Descriptor> & getDescriptors() const {
+        return descriptors;
+    }
+    inline const std::vector<std::string> & getReferences() const {
+        return references;
+    }
+
+    void reserve(size_t nodesNumber, size_t edgesNumber);
+
+protected:
+    Header header;
+
+    std::vector<Node> nodes;
+    std::vector<uint8_t> portDirections;
+    std::vector<Edge> edges;
+    std::vector<uint32_t> twinOffsets;
+    std::vector<int> twinMembers;
+    std::vector<Descriptor> descriptors;
+    std::vector<std::string> references;
+
+    std::unordered_map<std::string, uint32_t> descriptorsIndex;
+
+    friend class MachineIRImage;
+};
+
+#endif // MACHINEIR_H
@@ -0,0 +1,270 @@
+#include "machineirimage.h"
+
+#include <sstream>
+
+//"BFIR"
+const uint32_t MachineIRImage::MAGIC = 0x52494642;
+const uint32_t MachineIRImage::VERSION = 1;
+
+void MachineIRImage::write(const MachineIR & ir, std::ostream & out) throw(std::invalid_argument) {
+    writeU32(out, MAGIC);
+    writeU32(out, VERSION);
+
+    const MachineIR::Header & header = ir.getHeader();
+    uint64_t rateBits;
+    std::memcpy(&rateBits, &header.defaultRate, sizeof(rateBits));
+    writeU64(out, rateBits);
+    writeString(out, header.rateVolumeUnits);
+    writeString(out, header.rateTimeUnits);
+    writeU32(out, static_cast<uint32_t>(header.integerPrecission));
+    writeU32(out, static_cast<uint32_t>(header.decimalPrecission));
+
+    writeU32(out, ir.nodes.size());
+    for(const MachineIR::Node & node : ir.nodes) {
+        writeU32(out, static_cast<uint32_t>(node.id));
+        writeU32(out, node.kind);
+        writeU32(out, node.pins);
+        writeU32(out, node.firstPort);
+        writeU32(out, node.functions);
+        writeU32(out, node.extraFunctions);
+        writeU32(out, node.reference);
+    }
+
+    writeBytes(out, ir.portDirections);
+
+    writeU32(out, ir.edges.size());
+    for(const MachineIR::Edge & edge : ir.edges) {
+        writeU32(out, static_cast<uint32_t>(edge.source));
+        writeU32(out, static_cast<uint32_t>(edge.target));
+        writeU32(out, static_cast<uint32_t>(edge.sourcePort));
+        writeU32(out, static_cast<uint32_t>(edge.targetPort));
+    }
+
+    writeU32(out, ir.twinOffsets.size());
+    for(uint32_t offset : ir.twinOffsets) {
+        writeU32(out, offset);
+    }
+    writeU32(out, ir.twinMembers.size());
+    for(int member : ir.twinMembers) {
+        writeU32(out, static_cast<uint32_t>(member));
+    }
+
+    writeU32(out, ir.descriptors.size());
+    for(const MachineIR::Descriptor & descriptor : ir.descriptors) {
+        writeBytes(out, descriptor);
+    }
+
+    writeU32(out, ir.references.size());
+    for(const std::string & reference : ir.references) {
+        writeString(out, reference);
+    }
+
+    if (!out) {
+        throw(std::invalid_argument("MachineIRImage::write. error writing the image"));
+    }
+}
+
+std::shared_ptr<MachineIR> MachineIRImage::read(std::istream & in) throw(std::invalid_argument) {
+    try {
+        if (readU32(in) != MAGIC) {
+            throw(std::invalid_argument("not a machine image"));
+        }
+        uint32_t version = readU32(in);
+        if (version != VERSION) {
+            throw(std::invalid_argument("unsupported image version " + std::to_string(version)));
+        }
+
+        std::shared_ptr<MachineIR> ir = std::make_shared<MachineIR>();
+
+        uint64_t rateBits = readU64(in);
+        std::memcpy(&ir->header.defaultRate, &rateBits, sizeof(rateBits));
+        ir->header.rateVolumeUnits = readString(in);
+        ir->header.rateTimeUnits = readString(in);
+        ir->header.integerPrecission = static_cast<int32_t>(readU32(in));
+        ir->header.decimalPrecission = static_cast<int32_t>(readU32(in));
+
+        //the lengths are not trusted for the reservations, a corrupt one fails when the stream ends instead
+        uint32_t nodesNumber = readU32(in);
+        for(uint32_t i = 0; i < nodesNumber; i++) {
+            MachineIR::Node node;
+            node.id = static_cast<int32_t>(readU32(in));
+            node.kind = static_cast<uint8_t>(readU32(in));
+            node.pins = readU32(in);
+            node.firstPort = readU32(in);
+            node.functions = readU32(in);
+            node.extraFunctions = readU32(in);
+            node.reference = readU32(in);
+            ir->nodes.push_back(node);
+        }
+
+        ir->portDirections = readBytes(in);
+
+        uint32_t edgesNumber = readU32(in);
+        for(uint32_t i = 0; i < edgesNumber; i++) {
+            MachineIR::Edge edge;
+            edge.source = static_cast<int32_t>(readU32(in));
+            edge.target = static_cast<int32_t>(readU32(in));
+            edge.sourcePort = static_cast<int32_t>(readU32(in));
+            edge.targetPort = static_cast<int32_t>(readU32(in));
+            ir->edges.push_back(edge);
+        }
+
+        uint32_t offsetsNumber = readU32(in);
+        ir->twinOffsets.clear();
+        for(uint32_t i = 0; i < offsetsNumber; i++) {
+            ir->twinOffsets.push_back(readU32(in));
+        }
+        uint32_t membersNumber = readU32(in);
+        for(uint32_t i = 0; i < membersNumber; i++) {
+            ir->twinMembers.push_back(static_cast<int32_t>(readU32(in)));
+        }
+
+        uint32_t descriptorsNumber = readU32(in);
+        for(uint32_t i = 0; i < descriptorsNumber; i++) {
+            MachineIR::Descriptor descriptor = readBytes(in);
+            ir->descriptorsIndex.insert(std::make_pair(std::string(descriptor.begin(), descriptor.end()), i));
+            ir->descriptors.push_back(std::move(descriptor));
+        }
+
+        uint32_t referencesNumber = readU32(in);
+        for(uint32_t i = 0; i < referencesNumber; i++) {
+            ir->references.push_back(readString(in));
+        }
+
+        checkIndexes(*ir);
+        return ir;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("MachineIRImage::read. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+std::string MachineIRImage::toBytes(const MachineIR & ir) throw(std::invalid_argument) {
+    std::ostringstream out(std::ios::out | std::ios::binary);
+    write(ir, out);
+    return out.str();
+}
+
+std::shared_ptr<MachineIR> MachineIRImage::fromBytes(const std::string & bytes) throw(std::invalid_argument) {
+    std::istringstream in(bytes, std::ios::in | std::ios::binary);
+    return read(in);
+}
+
+void MachineIRImage::checkIndexes(const MachineIR & ir) throw(std::invalid_argument) {
+    int lastId = 0;
+    for(size_t i = 0; i < ir.nodes.size(); i++) {
+        const MachineIR::Node & node = ir.nodes[i];
+        if (i > 0 && node.id <= lastId) {
+            throw(std::invalid_argument("nodes out of order at node " + std::to_string(node.id)));
+        }
+        lastId = node.id;
+
+        if (node.kind > MachineIR::valve_node) {
+            throw(std::invalid_argument("unknow kind of node " + std::to_string(node.id)));
+        }
+        if (static_cast<uint64_t>(node.firstPort) + node.pins > ir.portDirections.size()) {
+            throw(std::invalid_argument("ports of node " + std::to_string(node.id) + " out of the image"));
+        }
+        if (node.functions >= ir.descriptors.size() ||
+            (node.extraFunctions != MachineIR::NO_DESCRIPTOR && node.extraFunctions >= ir.descriptors.size()))
+        {
+            throw(std::invalid_argument("descriptor of node " + std::to_string(node.id) + " out of the image"));
+        }
+        if (node.reference >= ir.references.size()) {
+            throw(std::invalid_argument("reference of node " + std::to_string(node.id) + " out of the image"));
+        }
+    }
+
+    //the ports of the edges are 0 based
+    for(const MachineIR::Edge & edge : ir.edges) {
+        const MachineIR::Node & source = ir.nodes[ir.getNodeIndex(edge.source)];
+        const MachineIR::Node & target = ir.nodes[ir.getNodeIndex(edge.target)];
+        if (edge.sourcePort < 0 || static_cast<uint32_t>(edge.sourcePort) >= source.pins ||
+            edge.targetPort < 0 || static_cast<uint32_t>(edge.targetPort) >= target.pins)
+        {
+            throw(std::invalid_argument("edge " + std::to_string(edge.source) + ":" + std::to_string(edge.sourcePort) +
+                                        " -> " + std::to_string(edge.target) + ":" + std::to_string(edge.targetPort) +
+                                        " out of the pins of its nodes"));
+        }
+    }
+
+    if (ir.twinOffsets.empty() || ir.twinOffsets.front() != 0 || ir.twinOffsets.back() != ir.twinMembers.size()) {
+        throw(std::invalid_argument("twin groups out of the image"));
+    }
+    for(size_t i = 1; i < ir.twinOffsets.size(); i++) {
+        if (ir.twinOffsets[i] < ir.twinOffsets[i-1]) {
+            throw(std::invalid_argument("twin groups out of order"));
+        }
+    }
+    for(int member : ir.twinMembers) {
+        if (ir.nodes[ir.getNodeIndex(member)].kind != MachineIR::valve_node) {
+            throw(std::invalid_argument("twin " + std::to_string(member) + " is not a valve"));
+        }
+    }
+}
+
+void MachineIRImage::writeU32(std::ostream & out, uint32_t value) {
+    char buffer[4];
+    for(int i = 0; i < 4; i++) {
+        buffer[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+    out.write(buffer, sizeof(buffer));
+}
+
+void MachineIRImage::writeU64(std::ostream & out, uint64_t value) {
+    writeU32(out, static_cast<uint32_t>(value & 0xffffffff));
+    writeU32(out, static_cast<uint32_t>(value >> 32));
+}
+
+void MachineIRImage::writeString(std::ostream & out, const std::string & value) {
+    writeU32(out, value.size());
+    out.write(value.data(), value.size());
+}
+
+void MachineIRImage::writeBytes(std::ostream & out, const std::vector<uint8_t> & bytes) {
+    writeU32(out, bytes.size());
+    out.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+uint32_t MachineIRImage::readU32(std::istream & in) throw(std::invalid_argument) {
+    unsigned char buffer[4];
+    readRaw(in, reinterpret_cast<char *>(buffer), sizeof(buffer));
+
+    uint32_t value = 0;
+    for(int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(buffer[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t MachineIRImage::readU64(std::istream & in) throw(std::invalid_argument) {
+    uint64_t low = readU32(in);
+    uint64_t high = readU32(in);
+    return low | (high << 32);
+}
+
+std::string MachineIRImage::readString(std::istream & in) throw(std::invalid_argument) {
+    std::vector<uint8_t> bytes = readBytes(in);
+    return std::string(bytes.begin(), bytes.end());
+}
+
+std::vector<uint8_t> MachineIRImage::readBytes(std::istream & in) throw(std::invalid_argument) {
+    uint32_t size = readU32(in);
+
+    //read in chunks so a corrupt length can not allocate more than the image has
+    std::vector<uint8_t> bytes;
+    const size_t CHUNK = 64 * 1024;
+    while(bytes.size() < size) {
+        size_t next = std::min<size_t>(CHUNK, size - bytes.size());
+        size_t offset = bytes.size();
+        bytes.resize(offset + next);
+        readRaw(in, reinterpret_cast<char *>(bytes.data() + offset), next);
+    }
+    return bytes;
+}
+
+void MachineIRImage::readRaw(std::istream & in, char * buffer, size_t size) throw(std::invalid_argument) {
+    in.read(buffer, size);
+    if (static_cast<size_t>(in.gcount()) != size) {
+        throw(std::invalid_argument("truncated image"));
+    }
+}
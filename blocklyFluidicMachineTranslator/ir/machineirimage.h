@@ -0,0 +1,47 @@
+#ifndef MACHINEIRIMAGE_H
+#define MACHINEIRIMAGE_H
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "blocklyFluidicMachineTranslator/ir/machineir.h"
+
+// binary image of a MachineIR: a magic number and a version followed by the header and every array of the IR, all the
+// integers little endian and every array preceded by its length, so an image can be stored or sent between processes
+// and read back without the Blockly JSON. read() checks the indexes of the image before returning it.
+class MachineIRImage
+{
+public:
+    static const uint32_t MAGIC;
+    static const uint32_t VERSION;
+
+    virtual ~MachineIRImage(){}
+
+    static void write(const MachineIR & ir, std::ostream & out) throw(std::invalid_argument);
+    static std::shared_ptr<MachineIR> read(std::istream & in) throw(std::invalid_argument);
+
+    static std::string toBytes(const MachineIR & ir) throw(std::invalid_argument);
+    static std::shared_ptr<MachineIR> fromBytes(const std::string & bytes) throw(std::invalid_argument);
+
+protected:
+    static void writeU32(std::ostream & out, uint32_t value);
+    static void writeU64(std::ostream & out, uint64_t value);
+    static void writeString(std::ostream & out, const std::string & value);
+    static void writeBytes(std::ostream & out, const std::vector<uint8_t> & bytes);
+
+    static uint32_t readU32(std::istream & in) throw(std::invalid_argument);
+    static uint64_t readU64(std::istream & in) throw(std::invalid_argument);
+    static std::string readString(std::istream & in) throw(std::invalid_argument);
+    static std::vector<uint8_t> readBytes(std::istream & in) throw(std::invalid_argument);
+    static void readRaw(std::istream & in, char * buffer, size_t size) throw(std::invalid_argument);
+
+    static void checkIndexes(const MachineIR & ir) throw(std::invalid_argument);
+};
+
+#endif // MACHINEIRIMAGE_H
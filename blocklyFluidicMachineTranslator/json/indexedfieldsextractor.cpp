@@ -0,0 +1,88 @@
+#include "indexedfieldsextractor.h"
+
+IndexedFieldsExtractor::IndexedFieldsExtractor(int firstIndex, int count) :
+    firstIndex(firstIndex), count(count < 0 ? 0 : count)
+{
+
+}
+
+IndexedFieldsExtractor::~IndexedFieldsExtractor() {
+
+}
+
+int IndexedFieldsExtractor::addPrefix(const std::string & prefix) {
+    prefixes.push_back(prefix);
+    fields.resize(prefixes.size() * count, NULL);
+    return prefixes.size() - 1;
+}
+
+void IndexedFieldsExtractor::extract(const nlohmann::json & obj) {
+    if (!obj.is_object()) {
+        return;
+    }
+
+    for(auto it = obj.begin(); it != obj.end(); ++it) {
+        const std::string & key = it.key();
+        for(size_t prefixIndex = 0; prefixIndex < prefixes.size(); prefixIndex++) {
+            const std::string & prefix = prefixes[prefixIndex];
+
+            int index;
+            if (key.size() > prefix.size() &&
+                key.compare(0, prefix.size(), prefix) == 0 &&
+                parseIndex(key, prefix.size(), index))
+            {
+                int position = index - firstIndex;
+                if (position >= 0 && position < count) {
+                    fields[prefixIndex * count + position] = &(*it);
+                }
+                break;
+            }
+        }
+    }
+}
+
+const nlohmann::json * IndexedFieldsExtractor::getField(int prefixIndex, int index) const {
+    int position = index - firstIndex;
+    if (prefixIndex < 0 || prefixIndex >= (int)prefixes.size() || position < 0 || position >= count) {
+        return NULL;
+    }
+    return fields[prefixIndex * count + position];
+}
+
+bool IndexedFieldsExtractor::isComplete() const {
+    for(const nlohmann::json * field : fields) {
+        if (field == NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void IndexedFieldsExtractor::checkComplete() const throw(std::invalid_argument) {
+    std::string missing;
+    for(size_t i = 0; i < fields.size(); i++) {
+        if (fields[i] == NULL) {
+            missing += (missing.empty() ? "" : ", ") + prefixes[i / count] + std::to_string(firstIndex + (int)(i % count));
+        }
+    }
+    if (!missing.empty()) {
+        throw(std::invalid_argument("missing fields: " + missing));
+    }
+}
+
+bool IndexedFieldsExtractor::parseIndex(const std::string & key, size_t start, int & index) {
+    //up to 9 digits so the value always fits in an int, no leading zeros so every index has one spelling
+    if (key.size() - start > 9 || (key[start] == '0' && key.size() - start > 1)) {
+        return false;
+    }
+
+    index = 0;
+    for(size_t i = start; i < key.size(); i++) {
+        char digit = key[i];
+        if (digit < '0' || digit > '9') {
+            return false;
+        }
+        index = index * 10 + (digit - '0');
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef INDEXEDFIELDSEXTRACTOR_H
+#define INDEXEDFIELDSEXTRACTOR_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+// collects the fields named <prefix><N> ("port1", "name0", "value0", "twin1"...) of an object in a single pass over its
+// keys, so no key string has to be built and looked up for every index.
+class IndexedFieldsExtractor
+{
+public:
+    IndexedFieldsExtractor(int firstIndex, int count);
+    virtual ~IndexedFieldsExtractor();
+
+    int addPrefix(const std::string & prefix);
+
+    void extract(const nlohmann::json & obj);
+
+    const nlohmann::json * getField(int prefixIndex, int index) const;
+
+    bool isComplete() const;
+    void checkComplete() const throw(std::invalid_argument);
+
+protected:
+    int firstIndex;
+    int count;
+
+    std::vector<std::string> prefixes;
+    std::vector<const nlohmann::json *> fields;
+
+    static bool parseIndex(const std::string & key, size_t start, int & index);
+};
+
+#endif // INDEXEDFIELDSEXTRACTOR_H
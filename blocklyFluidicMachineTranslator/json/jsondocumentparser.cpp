@@ -0,0 +1,129 @@
+#include "jsondocumentparser.h"
+
+#ifdef BLOCKLYTRANSLATOR_WITH_SIMDJSON
+#include <simdjson.h>
+#endif
+
+JsonDocumentParser::JsonDocumentParser(size_t maxNestingDepth, JsonLimitsScanner::ValueCheck valueCheck) :
+    maxNestingDepth(maxNestingDepth), valueCheck(valueCheck)
+#ifdef BLOCKLYTRANSLATOR_WITH_SIMDJSON
+    , parser(new simdjson::dom::parser())
+#endif
+{
+
+}
+
+JsonDocumentParser::~JsonDocumentParser() {
+
+}
+
+bool JsonDocumentParser::isSimdBackendAvailable() {
+#ifdef BLOCKLYTRANSLATOR_WITH_SIMDJSON
+    return true;
+#else
+    return false;
+#endif
+}
+
+nlohmann::json JsonDocumentParser::parse(std::istream & in) throw(std::invalid_argument) {
+    try {
+        if (!isLimited()) {
+            return parseStream(in);
+        }
+        //the scanner sees every chunk before the parser does
+        JsonLimitsScanner scanner(maxNestingDepth, valueCheck);
+        JsonLimitsStreamBuf buffer(in, scanner);
+        std::istream scanned(&buffer);
+        scanned.exceptions(std::ios::badbit);
+        return parseStream(scanned);
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("JsonDocumentParser::parse. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+nlohmann::json JsonDocumentParser::parse(const std::string & text) throw(std::invalid_argument) {
+    try {
+        if (isLimited()) {
+            JsonLimitsScanner scanner(maxNestingDepth, valueCheck);
+            scanner.scan(text.data(), text.size());
+            scanner.finish();
+        }
+        return parseText(text);
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("JsonDocumentParser::parse. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+bool JsonDocumentParser::isLimited() const {
+    return maxNestingDepth != std::numeric_limits<size_t>::max() || valueCheck;
+}
+
+nlohmann::json JsonDocumentParser::parseStream(std::istream & in) {
+#ifdef BLOCKLYTRANSLATOR_WITH_SIMDJSON
+    //simdjson needs the whole text
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return parseText(text);
+#else
+    nlohmann::json js;
+    in >> js;
+    return js;
+#endif
+}
+
+nlohmann::json JsonDocumentParser::parseText(const std::string & text) {
+#ifdef BLOCKLYTRANSLATOR_WITH_SIMDJSON
+    simdjson::dom::element root;
+    simdjson::error_code error = parser->parse(text).get(root);
+    if (error == simdjson::BIGINT_ERROR) {
+        //integers wider than 64 bits are left to nlohmann so they are converted the same way
+        return nlohmann::json::parse(text);
+    } else if (error) {
+        throw(std::invalid_argument(simdjson::error_message(error)));
+    }
+    return makeJson(root);
+#else
+    return nlohmann::json::parse(text);
+#endif
+}
+
+#ifdef BLOCKLYTRANSLATOR_WITH_SIMDJSON
+nlohmann::json JsonDocumentParser::makeJson(const simdjson::dom::element & element) {
+    switch (element.type()) {
+    case simdjson::dom::element_type::OBJECT: {
+        //the children are moved into place, no subtree is copied
+        nlohmann::json obj = nlohmann::json::object();
+        for(simdjson::dom::key_value_pair field : simdjson::dom::object(element)) {
+            obj.emplace(std::string(field.key.data(), field.key.size()), makeJson(field.value));
+        }
+        return obj;
+    }
+    case simdjson::dom::element_type::ARRAY: {
+        simdjson::dom::array children(element);
+        nlohmann::json array = nlohmann::json::array();
+        array.get_ref<nlohmann::json::array_t &>().reserve(children.size());
+        for(simdjson::dom::element child : children) {
+            array.emplace_back(makeJson(child));
+        }
+        return array;
+    }
+    case simdjson::dom::element_type::STRING:
+        return nlohmann::json(std::string(element.get_c_str().value_unsafe(), element.get_string_length().value_unsafe()));
+    case simdjson::dom::element_type::INT64: {
+        //nlohmann stores every non negative integer as unsigned
+        std::int64_t value = int64_t(element);
+        if (value >= 0) {
+            return nlohmann::json(static_cast<nlohmann::json::number_unsigned_t>(value));
+        }
+        return nlohmann::json(static_cast<nlohmann::json::number_integer_t>(value));
+    }
+    case simdjson::dom::element_type::UINT64:
+        return nlohmann::json(static_cast<nlohmann::json::number_unsigned_t>(uint64_t(element)));
+    case simdjson::dom::element_type::DOUBLE:
+        return nlohmann::json(static_cast<nlohmann::json::number_float_t>(double(element)));
+    case simdjson::dom::element_type::BOOL:
+        return nlohmann::json(bool(element));
+    default:
+        return nlohmann::json(nullptr);
+    }
+}
+#endif
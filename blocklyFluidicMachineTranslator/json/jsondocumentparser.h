@@ -0,0 +1,58 @@
+#ifndef JSONDOCUMENTPARSER_H
+#define JSONDOCUMENTPARSER_H
+
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <json.hpp>
+
+#include "blocklyFluidicMachineTranslator/json/jsonlimitsscanner.h"
+
+#ifdef BLOCKLYTRANSLATOR_WITH_SIMDJSON
+namespace simdjson {
+namespace dom {
+class parser;
+class element;
+}
+}
+#endif
+
+// entry point used by the translators to turn the input text into the json document they navigate. With
+// BLOCKLYTRANSLATOR_WITH_SIMDJSON (CONFIG += simdjson) the text is tokenized by simdjson and the resulting tree is
+// identical to the one the nlohmann parser builds, which is still used otherwise.
+//
+// both parsers recurse once per nested object or array, so a limited parser reads the input through a
+// JsonLimitsScanner, which rejects a deeper nesting, or any budget of the ValueCheck, as soon as it is read.
+class JsonDocumentParser
+{
+public:
+    JsonDocumentParser(size_t maxNestingDepth = std::numeric_limits<size_t>::max(),
+                       JsonLimitsScanner::ValueCheck valueCheck = JsonLimitsScanner::ValueCheck());
+    virtual ~JsonDocumentParser();
+
+    static bool isSimdBackendAvailable();
+
+    nlohmann::json parse(std::istream & in) throw(std::invalid_argument);
+    nlohmann::json parse(const std::string & text) throw(std::invalid_argument);
+
+protected:
+    size_t maxNestingDepth;
+    JsonLimitsScanner::ValueCheck valueCheck;
+
+#ifdef BLOCKLYTRANSLATOR_WITH_SIMDJSON
+    std::unique_ptr<simdjson::dom::parser> parser;
+
+    static nlohmann::json makeJson(const simdjson::dom::element & element);
+#endif
+
+    bool isLimited() const;
+    // the parse errors of both backends are left to parse() to wrap
+    nlohmann::json parseStream(std::istream & in);
+    nlohmann::json parseText(const std::string & text);
+};
+
+#endif // JSONDOCUMENTPARSER_H
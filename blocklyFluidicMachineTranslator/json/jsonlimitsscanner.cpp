@@ -0,0 +1,139 @@
+#include "jsonlimitsscanner.h"
+
+#include <cstdlib>
+
+#include "blocklyFluidicMachineTranslator/translationlimits.h"
+
+JsonLimitsScanner::JsonLimitsScanner(size_t maxNestingDepth, ValueCheck valueCheck) :
+    maxNestingDepth(maxNestingDepth), valueCheck(valueCheck), inString(false), inKey(false), escaped(false),
+    expectingKey(false), inNumber(false)
+{
+
+}
+
+JsonLimitsScanner::~JsonLimitsScanner() {
+
+}
+
+void JsonLimitsScanner::scan(const char * data, size_t size) throw(std::invalid_argument) {
+    for(size_t i = 0; i < size; i++) {
+        char c = data[i];
+        if (inString) {
+            //only the keys are kept, the escaped characters of a key are kept as written
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+                continue;
+            } else if (c == '"') {
+                inString = false;
+                if (inKey) {
+                    keys.back().swap(token);
+                    inKey = false;
+                }
+                continue;
+            }
+            if (inKey) {
+                token += c;
+            }
+            continue;
+        }
+
+        if (inNumber) {
+            if (isNumberChar(c)) {
+                token += c;
+                continue;
+            }
+            endNumber();
+        }
+
+        switch (c) {
+        case '"':
+            inString = true;
+            inKey = expectingKey;
+            token.clear();
+            break;
+        case '{':
+        case '[':
+            openContainer(c);
+            break;
+        case '}':
+        case ']':
+            closeContainer();
+            break;
+        case ',':
+            expectingKey = (!containers.empty() && containers.back() == '{');
+            break;
+        case ':':
+            expectingKey = false;
+            break;
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                inNumber = true;
+                token.assign(1, c);
+            }
+            break;
+        }
+    }
+}
+
+void JsonLimitsScanner::finish() throw(std::invalid_argument) {
+    if (inNumber) {
+        endNumber();
+    }
+}
+
+void JsonLimitsScanner::openContainer(char container) throw(std::invalid_argument) {
+    TranslationLimits::check(containers.size() + 1, maxNestingDepth, "nesting depth");
+    if (valueCheck) {
+        valueCheck(keys, NULL);
+    }
+    containers.push_back(container);
+    keys.push_back(std::string());
+    expectingKey = (container == '{');
+}
+
+void JsonLimitsScanner::closeContainer() {
+    if (!containers.empty()) {
+        containers.pop_back();
+        keys.pop_back();
+    }
+    expectingKey = false;
+}
+
+void JsonLimitsScanner::endNumber() throw(std::invalid_argument) {
+    inNumber = false;
+    if (valueCheck) {
+        double number = std::strtod(token.c_str(), NULL);
+        valueCheck(keys, &number);
+    }
+}
+
+bool JsonLimitsScanner::isNumberChar(char c) {
+    return (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '-' || c == '+';
+}
+
+JsonLimitsStreamBuf::JsonLimitsStreamBuf(std::istream & source, JsonLimitsScanner & scanner, size_t chunkSize) :
+    source(source.rdbuf()), scanner(scanner), buffer(chunkSize)
+{
+    setg(buffer.data(), buffer.data(), buffer.data());
+}
+
+JsonLimitsStreamBuf::~JsonLimitsStreamBuf() {
+
+}
+
+JsonLimitsStreamBuf::int_type JsonLimitsStreamBuf::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::streamsize read = source->sgetn(buffer.data(), buffer.size());
+    if (read <= 0) {
+        scanner.finish();
+        return traits_type::eof();
+    }
+    scanner.scan(buffer.data(), read);
+    setg(buffer.data(), buffer.data(), buffer.data() + read);
+    return traits_type::to_int_type(*gptr());
+}
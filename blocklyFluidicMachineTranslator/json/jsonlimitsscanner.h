@@ -0,0 +1,67 @@
+#ifndef JSONLIMITSSCANNER_H
+#define JSONLIMITSSCANNER_H
+
+#include <functional>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// follows the structure of a json text as it is read, without building anything, so the limits of a document are
+// enforced before a parser recurses into it or builds the rest of it. It throws as soon as a container is nested deeper
+// than maxNestingDepth and hands the keys leading to every object, array and number to the ValueCheck. Anything that is
+// not json is left for the parser to reject.
+class JsonLimitsScanner
+{
+public:
+    // keys from the root to the value, an array element has an empty key. number is NULL for an object or an array,
+    // reported as it opens; a number is reported once read. It throws to stop the read
+    typedef std::function<void(const std::vector<std::string> & keys, const double * number)> ValueCheck;
+
+    JsonLimitsScanner(size_t maxNestingDepth = std::numeric_limits<size_t>::max(), ValueCheck valueCheck = ValueCheck());
+    virtual ~JsonLimitsScanner();
+
+    // the text can be given in pieces of any size
+    void scan(const char * data, size_t size) throw(std::invalid_argument);
+    // a number closing the text has nothing after it that ends it
+    void finish() throw(std::invalid_argument);
+
+protected:
+    size_t maxNestingDepth;
+    ValueCheck valueCheck;
+
+    std::vector<char> containers;
+    std::vector<std::string> keys;
+
+    bool inString;
+    bool inKey;
+    bool escaped;
+    bool expectingKey;
+    bool inNumber;
+    std::string token;
+
+    void openContainer(char container) throw(std::invalid_argument);
+    void closeContainer();
+    void endNumber() throw(std::invalid_argument);
+
+    static bool isNumberChar(char c);
+};
+
+// hands out the contents of the source stream in chunks, every chunk goes through the scanner before the reader sees it
+class JsonLimitsStreamBuf : public std::streambuf
+{
+public:
+    JsonLimitsStreamBuf(std::istream & source, JsonLimitsScanner & scanner, size_t chunkSize = 64 * 1024);
+    virtual ~JsonLimitsStreamBuf();
+
+protected:
+    std::streambuf* source;
+    JsonLimitsScanner & scanner;
+    std::vector<char> buffer;
+
+    virtual int_type underflow();
+};
+
+#endif // JSONLIMITSSCANNER_H
@@ -0,0 +1,67 @@
+#include "jsonschema.h"
+
+JsonSchema::JsonSchema(const std::vector<std::string> & requiredFields, const std::vector<std::string> & optionalFields)
+    throw(std::invalid_argument) :
+    requiredMask(0)
+{
+    if (requiredFields.size() + optionalFields.size() > MAX_FIELDS) {
+        throw(std::invalid_argument("JsonSchema::JsonSchema. a schema can have at most " + std::to_string(MAX_FIELDS) + " fields"));
+    }
+
+    for(const std::string & field : requiredFields) {
+        requiredMask |= UINT64_C(1) << fieldNames.size();
+        fieldIndexes.insert(std::make_pair(field, fieldNames.size()));
+        fieldNames.push_back(field);
+    }
+    for(const std::string & field : optionalFields) {
+        fieldIndexes.insert(std::make_pair(field, fieldNames.size()));
+        fieldNames.push_back(field);
+    }
+}
+
+JsonSchema::~JsonSchema() {
+
+}
+
+JsonSchema::Fields JsonSchema::validate(const nlohmann::json & obj) const throw(std::invalid_argument) {
+    if (!obj.is_object()) {
+        throw(std::invalid_argument("expected an object, found: " + describeValue(obj)));
+    }
+
+    Fields fields(fieldNames.size(), NULL);
+    std::uint64_t seenMask = 0;
+
+    for(auto it = obj.begin(); it != obj.end(); ++it) {
+        auto finded = fieldIndexes.find(it.key());
+        if (finded != fieldIndexes.end()) {
+            fields[finded->second] = &(*it);
+            seenMask |= UINT64_C(1) << finded->second;
+        }
+    }
+
+    std::uint64_t missingMask = requiredMask & ~seenMask;
+    if (missingMask != 0) {
+        std::string missing;
+        for(size_t i = 0; i < fieldNames.size(); i++) {
+            if (missingMask & (UINT64_C(1) << i)) {
+                missing += (missing.empty() ? "" : ", ") + fieldNames[i];
+            }
+        }
+        throw(std::invalid_argument("missing properties: " + missing));
+    }
+    return fields;
+}
+
+std::string JsonSchema::describeValue(const nlohmann::json & obj) {
+    //containers are not dumped, they can be as large as the whole document
+    std::string description = obj.type_name();
+    if (obj.is_array()) {
+        description += " of " + std::to_string(obj.size()) + " elements";
+    } else if (obj.is_string()) {
+        const std::string & value = obj.get_ref<const std::string &>();
+        description += " \"" + value.substr(0, MAX_ERROR_VALUE_LENGTH) + (value.size() > MAX_ERROR_VALUE_LENGTH ? "...\"" : "\"");
+    } else if (!obj.is_null()) {
+        description += " " + obj.dump();
+    }
+    return description;
+}
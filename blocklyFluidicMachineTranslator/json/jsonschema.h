@@ -0,0 +1,41 @@
+#ifndef JSONSCHEMA_H
+#define JSONSCHEMA_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <json.hpp>
+
+// list of fields an object must (or may) have, compiled once into a name -> index table. validate() walks the
+// object a single time, marks the seen fields in a bitmask and returns where each field is, in declaration order,
+// so the parsers read the values without looking them up again.
+class JsonSchema
+{
+public:
+    typedef std::vector<const nlohmann::json *> Fields;
+
+    JsonSchema(const std::vector<std::string> & requiredFields,
+               const std::vector<std::string> & optionalFields = std::vector<std::string>()) throw(std::invalid_argument);
+    virtual ~JsonSchema();
+
+    Fields validate(const nlohmann::json & obj) const throw(std::invalid_argument);
+
+    int getFieldsNumber() const {
+        return fieldNames.size();
+    }
+
+protected:
+    static const int MAX_FIELDS = 64;
+    static const size_t MAX_ERROR_VALUE_LENGTH = 64;
+
+    std::vector<std::string> fieldNames;
+    std::unordered_map<std::string, int> fieldIndexes;
+    std::uint64_t requiredMask;
+
+    static std::string describeValue(const nlohmann::json & obj);
+};
+
+#endif // JSONSCHEMA_H
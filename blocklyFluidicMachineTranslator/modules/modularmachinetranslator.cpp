@@ -0,0 +1,341 @@
+#include "modularmachinetranslator.h"
+
+using json = nlohmann::json;
+
+const std::string ModularMachineTranslator::MODULE_SEPARATOR_STR = "::";
+
+namespace {
+enum ManifestFields { MANIFEST_MODULES };
+enum ModuleFields { MODULE_NAME, MODULE_PATH };
+}
+
+const JsonSchema ModularMachineTranslator::MANIFEST_SCHEMA({"modules"});
+const JsonSchema ModularMachineTranslator::MODULE_SCHEMA({"name", "path"});
+
+ModularMachineTranslator::ModularMachineTranslator(
+        const std::string & manifestPath,
+        std::shared_ptr<PluginAbstractFactory> factory,
+        std::shared_ptr<ModuleCache> cache) :
+    BlocklyFluidicMachineTranslator(manifestPath, factory)
+{
+    this->cache = cache;
+    this->threadsNumber = std::max<int>(std::thread::hardware_concurrency(), 1);
+}
+
+ModularMachineTranslator::ModularMachineTranslator(
+        const std::string & manifestPath,
+        std::shared_ptr<const TranslationContext> context,
+        std::shared_ptr<ModuleCache> cache) :
+    BlocklyFluidicMachineTranslator(manifestPath, context)
+{
+    this->cache = cache;
+    this->threadsNumber = std::max<int>(std::thread::hardware_concurrency(), 1);
+}
+
+ModularMachineTranslator::~ModularMachineTranslator() {
+
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple ModularMachineTranslator::translateModules() {
+    return translateModules(std::shared_ptr<TranslationMonitor>());
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple ModularMachineTranslator::translateModules(std::shared_ptr<TranslationMonitor> monitor) {
+    BLOCKLY_TRACE_SPAN(span, "translateModules");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    resetState();
+    this->monitor = monitor;
+
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    try {
+        DecompressingInputStream input(in, limits.maxInputBytes);
+
+        JsonDocumentParser parser(limits.maxNestingDepth);
+        json manifest;
+        {
+            PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::parse);
+            manifest = parser.parse(input);
+        }
+
+        JsonSchema::Fields headerFields = HEADER_SCHEMA.validate(manifest);
+        JsonSchema::Fields manifestFields = MANIFEST_SCHEMA.validate(manifest);
+
+        std::vector<std::string> moduleNames;
+        std::vector<std::string> modulePaths;
+
+        const json & modules = *manifestFields[MANIFEST_MODULES];
+        for(auto it = modules.begin(); it != modules.end(); ++it) {
+            JsonSchema::Fields moduleFields = MODULE_SCHEMA.validate(*it);
+
+            std::string moduleName = *moduleFields[MODULE_NAME];
+            std::string modulePath = *moduleFields[MODULE_PATH];
+            if (moduleName.empty() || moduleName.find(MODULE_SEPARATOR_STR) != std::string::npos) {
+                throw(std::invalid_argument("invalid module name \"" + moduleName + "\""));
+            }
+            if (std::find(moduleNames.begin(), moduleNames.end(), moduleName) != moduleNames.end()) {
+                throw(std::invalid_argument("module " + moduleName + " declared twice"));
+            }
+
+            moduleNames.push_back(moduleName);
+            modulePaths.push_back(modulePath);
+        }
+
+        std::vector<ModuleCache::TranslatedModulePtr> translatedModules = translateModuleFiles(moduleNames, modulePaths);
+
+        int totalBlocks = 0;
+        for(const ModuleCache::TranslatedModulePtr & module : translatedModules) {
+            totalBlocks += module->definedReferences.size();
+        }
+        TranslationLimits::check(totalBlocks, limits.maxBlocks, "blocks");
+
+        //link: the translated modules are joined, in the order of the manifest, into the same graph
+        model = std::make_shared<MachineGraph>();
+
+        std::unordered_set<std::string> definedReferences;
+        int linkedBlocks = 0;
+        for(const ModuleCache::TranslatedModulePtr & module : translatedModules) {
+            checkInterruption();
+            {
+                PhaseCounters::Scope countersScope(phaseCounters.get(), PhaseCounters::configuration_blocks);
+                linkModule(*module);
+            }
+            definedReferences.insert(module->definedReferences.begin(), module->definedReferences.end());
+
+            linkedBlocks += module->definedReferences.size();
+            if (monitor) {
+                monitor->reportProgress(linkedBlocks, totalBlocks);
+            }
+        }
+
+        for(const auto & variablePair : variableIdMap) {
+            if (definedReferences.find(variablePair.first) == definedReferences.end()) {
+                throw(std::invalid_argument("unresolved reference " + variablePair.first));
+            }
+        }
+
+        return makeModelMapping(headerFields);
+    } catch (TranslationInterruptedException & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("ModularMachineTranslator::translateModules. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+std::string ModularMachineTranslator::qualifyReference(const std::string & moduleName, const std::string & reference) {
+    if (reference.find(MODULE_SEPARATOR_STR) != std::string::npos) {
+        return reference;
+    }
+    return moduleName + MODULE_SEPARATOR_STR + reference;
+}
+
+std::vector<ModuleCache::TranslatedModulePtr> ModularMachineTranslator::translateModuleFiles(
+        const std::vector<std::string> & moduleNames,
+        const std::vector<std::string> & modulePaths)
+{
+    std::vector<ModuleCache::TranslatedModulePtr> translatedModules(moduleNames.size());
+    std::atomic<size_t> nextModule(0);
+    std::atomic<bool> failed(false);
+
+    //a bounded number of workers take the modules in order; the futures are declared last so they are joined before
+    //the variables they use go away, even when get() throws
+    std::vector<std::future<void>> workers;
+    size_t workersNumber = std::min<size_t>(threadsNumber, moduleNames.size());
+    for(size_t i = 0; i < workersNumber; i++) {
+        workers.push_back(std::async(std::launch::async, [this, &moduleNames, &modulePaths, &translatedModules, &nextModule, &failed]() {
+            for(size_t module = nextModule++; module < moduleNames.size() && !failed; module = nextModule++) {
+                try {
+                    translatedModules[module] = translateModule(moduleNames[module], modulePaths[module]);
+                } catch (...) {
+                    failed = true;
+                    throw;
+                }
+            }
+        }));
+    }
+    for(std::future<void> & worker : workers) {
+        worker.get();
+    }
+    return translatedModules;
+}
+
+ModuleCache::TranslatedModulePtr ModularMachineTranslator::translateModule(const std::string & moduleName, const std::string & modulePath)
+    throw(std::invalid_argument, TranslationInterruptedException)
+{
+    BLOCKLY_TRACE_SPAN(span, "translateModule");
+    BLOCKLY_TRACE_ARG(span, "module", moduleName);
+    try {
+        std::string filePath = makeModulePath(modulePath);
+        std::ifstream in(filePath, std::ios::in | std::ios::binary);
+        if (!in.is_open()) {
+            throw(std::invalid_argument("unable to open " + modulePath));
+        }
+        //read through the limited stream so a module larger than maxInputBytes is never held in memory
+        std::string contentStr;
+        {
+            DecompressingInputStream input(in, limits.maxInputBytes);
+            char chunk[64 * 1024];
+            while (input.read(chunk, sizeof(chunk)) || input.gcount() > 0) {
+                contentStr.append(chunk, input.gcount());
+            }
+        }
+
+        //the module name, the lazy extra functions and the node labels change the translated state as much as the content does
+        std::string key = filePath + "|" + moduleName + (lazyExtraFunctions ? "|lazy" : "") + (fingerprintEnabled ? "|labels" : "");
+        uint64_t contentHash = MachineFingerprint::hashBytes(contentStr);
+
+        ModuleCache::TranslatedModulePtr cachedModule = cache->find(key, contentHash);
+        if (cachedModule) {
+            return cachedModule;
+        }
+
+        std::istringstream input(contentStr);
+        JsonDocumentParser parser(limits.maxNestingDepth, makeLimitsCheck({"connections"}));
+        json moduleObj = parser.parse(input);
+        UtilsJSON::checkPropertiesExists(std::vector<std::string>{"connections"}, moduleObj);
+
+        json & blocks = moduleObj["connections"];
+        TranslationLimits::check(blocks.size(), limits.maxBlocks, "blocks");
+
+        //the blocks go through a translator of their own, its state is what the cache keeps
+        ModularMachineTranslator moduleTranslator(filePath, context, cache);
+        moduleTranslator.setLimits(limits);
+        moduleTranslator.setLazyExtraFunctions(lazyExtraFunctions);
+        moduleTranslator.setFingerprintEnabled(fingerprintEnabled);
+        moduleTranslator.resetState();
+        moduleTranslator.monitor = monitor;
+
+        std::shared_ptr<ModuleCache::TranslatedModule> translatedModule = std::make_shared<ModuleCache::TranslatedModule>();
+        for(auto it = blocks.begin(); it != blocks.end(); ++it) {
+            moduleTranslator.checkInterruption();
+
+            json & configurationBlock = *it;
+            qualifyBlock(moduleName, configurationBlock);
+            moduleTranslator.processConfigurationBlock(configurationBlock);
+            translatedModule->definedReferences.insert(configurationBlock["reference"].get<std::string>());
+        }
+
+        translatedModule->variableIdMap = std::move(moduleTranslator.variableIdMap);
+        translatedModule->connectionsMap = std::move(moduleTranslator.connectionsMap);
+        translatedModule->directedConnectionsMapsIn = std::move(moduleTranslator.directedConnectionsMapsIn);
+        translatedModule->directedConnectionsMapsOut = std::move(moduleTranslator.directedConnectionsMapsOut);
+        translatedModule->twinsVector = std::move(moduleTranslator.twinsVector);
+        translatedModule->valveIds = std::move(moduleTranslator.valveIds);
+        translatedModule->pendingNodes = std::move(moduleTranslator.pendingNodes);
+        translatedModule->nodeLabels = std::move(moduleTranslator.nodeLabels);
+        translatedModule->portConnections = moduleTranslator.portConnections;
+        translatedModule->estimatedMemory = moduleTranslator.estimatedMemory;
+
+        cache->insert(key, contentHash, translatedModule);
+        return translatedModule;
+    } catch (TranslationInterruptedException & e) {
+        throw;
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("ModularMachineTranslator::translateModule. module " + moduleName + ": " + std::string(e.what())));
+    }
+}
+
+void ModularMachineTranslator::linkModule(const ModuleCache::TranslatedModule & module) throw(std::invalid_argument) {
+    try {
+        std::unordered_map<int,int> globalIds;
+        globalIds.reserve(module.variableIdMap.size());
+        for(const auto & variablePair : module.variableIdMap) {
+            globalIds.insert(std::make_pair(variablePair.second, getReferenceId(variablePair.first)));
+        }
+        auto globalId = [&globalIds](int localId) {
+            return globalIds.at(localId);
+        };
+
+        for(const auto & connectionPair : module.connectionsMap) {
+            std::unordered_map<float,int> & portMap = connectionsMap[globalId(connectionPair.first)];
+            for(const auto & portConnection : connectionPair.second) {
+                int target = std::floor(portConnection.first);
+                int copyLevel = std::lround((portConnection.first - target) * 10);
+                portMap.insert(std::make_pair(makeCopyReference(globalId(target), copyLevel), portConnection.second));
+            }
+        }
+        for(const auto & directionPair : module.directedConnectionsMapsIn) {
+            addDirectionPorts(globalId(directionPair.first),
+                              directionPair.second,
+                              module.directedConnectionsMapsOut.at(directionPair.first));
+        }
+        for(const std::unordered_set<int> & twins : module.twinsVector) {
+            std::unordered_set<int> linkedTwins;
+            for(int twin : twins) {
+                linkedTwins.insert(globalId(twin));
+            }
+            twinsVector.push_back(linkedTwins);
+        }
+        for(int valveId : module.valveIds) {
+            valveIds.insert(globalId(valveId));
+        }
+
+        for(const auto & pendingPair : module.pendingNodes) {
+            addPendingNode(globalId(pendingPair.first), pendingPair.second);
+        }
+        for(const auto & labelPair : module.nodeLabels) {
+            nodeLabels[globalId(labelPair.first)] = labelPair.second;
+        }
+
+        portConnections += module.portConnections;
+        TranslationLimits::check(portConnections, limits.maxEdges * 2, "port connections");
+        addEstimatedMemory(module.estimatedMemory);
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("ModularMachineTranslator::linkModule. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+void ModularMachineTranslator::qualifyBlock(const std::string & moduleName, nlohmann::json & blockObj) throw(std::invalid_argument) {
+    if (!blockObj.is_object()) {
+        return;
+    }
+
+    for(auto it = blockObj.begin(); it != blockObj.end(); ++it) {
+        if (it.key() == "reference" && it.value().is_string()) {
+            //a block can only define a reference of its own module
+            std::string reference = it.value().get<std::string>();
+            if (reference.find(MODULE_SEPARATOR_STR) != std::string::npos) {
+                throw(std::invalid_argument("local reference \"" + reference + "\" can not contain \"" + MODULE_SEPARATOR_STR + "\""));
+            }
+            it.value() = qualifyReference(moduleName, reference);
+        } else if (isIndexedKey(it.key(), "port") || isIndexedKey(it.key(), "twin")) {
+            qualifyReferenceBlock(moduleName, it.value());
+        }
+    }
+}
+
+void ModularMachineTranslator::qualifyReferenceBlock(const std::string & moduleName, nlohmann::json & referenceObj) {
+    //part copies nest the referenced block inside "reference", the innermost one holds the name
+    json * actual = &referenceObj;
+    while(actual->is_object() && actual->find("reference") != actual->end()) {
+        json & reference = (*actual)["reference"];
+        if (reference.is_string()) {
+            reference = qualifyReference(moduleName, reference.get<std::string>());
+            return;
+        }
+        actual = &reference;
+    }
+}
+
+bool ModularMachineTranslator::isIndexedKey(const std::string & key, const std::string & prefix) {
+    if (key.size() <= prefix.size() || key.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    for(size_t i = prefix.size(); i < key.size(); i++) {
+        if (key[i] < '0' || key[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string ModularMachineTranslator::makeModulePath(const std::string & modulePath) const {
+    bool absolute = (!modulePath.empty() && (modulePath[0] == '/' || modulePath[0] == '\\')) ||
+                    (modulePath.size() > 1 && modulePath[1] == ':');
+
+    size_t separator = path.find_last_of("/\\");
+    if (absolute || separator == std::string::npos) {
+        return modulePath;
+    }
+    return path.substr(0, separator + 1) + modulePath;
+}
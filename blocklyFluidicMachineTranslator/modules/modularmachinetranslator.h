@@ -0,0 +1,72 @@
+#ifndef MODULARMACHINETRANSLATOR_H
+#define MODULARMACHINETRANSLATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <json.hpp>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "blocklyFluidicMachineTranslator/modules/modulecache.h"
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator_global.h"
+
+// translates a machine split in several module files. The file given as path is a manifest with the usual header
+// fields and a "modules" list of {"name", "path"} objects, module paths being relative to the manifest. Every module is a
+// normal machine file whose references are local to it; "module::reference" points to a block of another module.
+// Every module is translated on its own, in parallel by at most getThreadsNumber() threads, and kept in the ModuleCache
+// while its file does not change. The link then joins the translated modules into a single MachineGraph, so a change
+// in one module only translates that module again. The hardware counters of the translator only cover the link.
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT ModularMachineTranslator : public BlocklyFluidicMachineTranslator
+{
+    static const std::string MODULE_SEPARATOR_STR;
+    static const JsonSchema MANIFEST_SCHEMA;
+    static const JsonSchema MODULE_SCHEMA;
+
+public:
+    ModularMachineTranslator(const std::string & manifestPath,
+                             std::shared_ptr<PluginAbstractFactory> factory,
+                             std::shared_ptr<ModuleCache> cache = std::make_shared<ModuleCache>());
+    ModularMachineTranslator(const std::string & manifestPath,
+                             std::shared_ptr<const TranslationContext> context,
+                             std::shared_ptr<ModuleCache> cache = std::make_shared<ModuleCache>());
+    virtual ~ModularMachineTranslator();
+
+    ModelMappingTuple translateModules();
+    ModelMappingTuple translateModules(std::shared_ptr<TranslationMonitor> monitor);
+
+    // threads translating the modules, the hardware concurrency by default
+    void setThreadsNumber(int threadsNumber) {
+        this->threadsNumber = std::max(threadsNumber, 1);
+    }
+    int getThreadsNumber() const {
+        return threadsNumber;
+    }
+
+    static std::string qualifyReference(const std::string & moduleName, const std::string & reference);
+
+protected:
+    std::shared_ptr<ModuleCache> cache;
+    int threadsNumber;
+
+    std::vector<ModuleCache::TranslatedModulePtr> translateModuleFiles(const std::vector<std::string> & moduleNames,
+                                                                       const std::vector<std::string> & modulePaths);
+    ModuleCache::TranslatedModulePtr translateModule(const std::string & moduleName, const std::string & modulePath)
+        throw(std::invalid_argument, TranslationInterruptedException);
+    void linkModule(const ModuleCache::TranslatedModule & module) throw(std::invalid_argument);
+
+    static void qualifyBlock(const std::string & moduleName, nlohmann::json & blockObj) throw(std::invalid_argument);
+    static void qualifyReferenceBlock(const std::string & moduleName, nlohmann::json & referenceObj);
+    static bool isIndexedKey(const std::string & key, const std::string & prefix);
+
+    std::string makeModulePath(const std::string & modulePath) const;
+};
+
+#endif // MODULARMACHINETRANSLATOR_H
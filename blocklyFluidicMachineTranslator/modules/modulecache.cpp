@@ -0,0 +1,50 @@
+#include "modulecache.h"
+
+ModuleCache::ModuleCache() {
+    hits = 0;
+    misses = 0;
+}
+
+ModuleCache::~ModuleCache() {
+
+}
+
+ModuleCache::TranslatedModulePtr ModuleCache::find(const std::string & key, uint64_t contentHash) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    auto finded = entries.find(key);
+    if (finded != entries.end() && finded->second.contentHash == contentHash) {
+        hits++;
+        return finded->second.module;
+    }
+    misses++;
+    return TranslatedModulePtr();
+}
+
+void ModuleCache::insert(const std::string & key, uint64_t contentHash, TranslatedModulePtr module) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    CacheEntry & entry = entries[key];
+    entry.contentHash = contentHash;
+    entry.module = module;
+}
+
+void ModuleCache::clear() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    entries.clear();
+}
+
+size_t ModuleCache::size() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return entries.size();
+}
+
+size_t ModuleCache::getHits() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return hits;
+}
+
+size_t ModuleCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return misses;
+}
@@ -0,0 +1,75 @@
+#ifndef MODULECACHE_H
+#define MODULECACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fluidicmachinemodel/machinegraph.h>
+
+#include "blocklyFluidicMachineTranslator/blocks/deferredfunctionsstore.h"
+#include "blocklyFluidicMachineTranslator/graph/portset.h"
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator_global.h"
+
+// translated modules keyed by module file, and checked against the hash of the file content, so a module is only
+// translated again when its file changes. Every key keeps only its last translation. The translated nodes share
+// their plugin functions, so a cache can be shared by translators running in parallel as long as they use the same
+// plugin factory.
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT ModuleCache
+{
+public:
+    typedef std::function<void(int nodeId, MachineGraph & graph, DeferredFunctionsStore * store)> NodeMaker;
+
+    // state left by the translation of the blocks of a module, with ids local to the module. The references are
+    // already qualified by the module name, the ones of other modules get a local id too and are resolved when the
+    // modules are linked.
+    struct TranslatedModule {
+        std::unordered_map<std::string, int> variableIdMap;
+        std::unordered_set<std::string> definedReferences;
+
+        std::unordered_map<int,std::unordered_map<float,int>> connectionsMap;
+        std::unordered_map<int,PortSet> directedConnectionsMapsIn;
+        std::unordered_map<int,PortSet> directedConnectionsMapsOut;
+        std::vector<std::unordered_set<int>> twinsVector;
+        std::unordered_set<int> valveIds;
+
+        std::vector<std::pair<int, NodeMaker>> pendingNodes;
+        std::unordered_map<int, uint64_t> nodeLabels;
+
+        size_t portConnections;
+        size_t estimatedMemory;
+    };
+    typedef std::shared_ptr<const TranslatedModule> TranslatedModulePtr;
+
+    ModuleCache();
+    virtual ~ModuleCache();
+
+    TranslatedModulePtr find(const std::string & key, uint64_t contentHash) const;
+    void insert(const std::string & key, uint64_t contentHash, TranslatedModulePtr module);
+
+    void clear();
+    size_t size() const;
+
+    size_t getHits() const;
+    size_t getMisses() const;
+
+protected:
+    struct CacheEntry {
+        uint64_t contentHash;
+        TranslatedModulePtr module;
+    };
+
+    mutable std::mutex cacheMutex;
+    std::unordered_map<std::string, CacheEntry> entries;
+
+    mutable size_t hits;
+    mutable size_t misses;
+};
+
+#endif // MODULECACHE_H
@@ -0,0 +1,500 @@
+#include "translationprocesspool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <limits>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "blocklyFluidicMachineTranslator/ir/machineirimage.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+TranslationProcessPool::TranslationProcessPool(
+        std::shared_ptr<const TranslationContext> context,
+        size_t workersNumber,
+        int timeoutMs,
+        ModelJob modelJob)
+    throw(std::invalid_argument) :
+    context(context), timeoutMs(timeoutMs), modelJob(modelJob), spawnerPid(-1), spawnerSocket(-1), restartedWorkers(0)
+{
+    if (workersNumber == 0) {
+        throw(std::invalid_argument("TranslationProcessPool::TranslationProcessPool. zero workers"));
+    }
+
+    try {
+        startSpawner();
+        for(size_t i = 0; i < workersNumber; i++) {
+            workers.push_back(spawnWorker());
+            idleWorkers.push_back(i);
+        }
+    } catch (std::exception & e) {
+        for(const Worker & worker : workers) {
+            close(worker.socket);
+        }
+        if (spawnerPid > 0) {
+            close(spawnerSocket);
+            waitpid(spawnerPid, NULL, 0);
+        }
+        throw(std::invalid_argument("TranslationProcessPool::TranslationProcessPool. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+TranslationProcessPool::~TranslationProcessPool() {
+    //the workers leave when their socket is closed, the spawner waits for all of them when its own is closed
+    for(const Worker & worker : workers) {
+        if (worker.pid > 0) {
+            close(worker.socket);
+        }
+    }
+    close(spawnerSocket);
+    waitpid(spawnerPid, NULL, 0);
+}
+
+std::shared_ptr<MachineIR> TranslationProcessPool::translate(const std::string & path) throw(std::invalid_argument) {
+    BLOCKLY_TRACE_SPAN(span, "TranslationProcessPool::translate");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    std::string payload = request(path, request_ir, NULL);
+    try {
+        return MachineIRImage::fromBytes(payload);
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("TranslationProcessPool::translate. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+std::shared_ptr<MachineIR> TranslationProcessPool::translate(const std::string & path, MachineFingerprint & fingerprint)
+    throw(std::invalid_argument)
+{
+    BLOCKLY_TRACE_SPAN(span, "TranslationProcessPool::translate");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    std::string payload = request(path, request_ir, &fingerprint);
+    try {
+        return MachineIRImage::fromBytes(payload);
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("TranslationProcessPool::translate. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+std::future<std::shared_ptr<MachineIR>> TranslationProcessPool::translateAsync(const std::string & path) {
+    return std::async(std::launch::async, [this, path]() {
+        return translate(path);
+    });
+}
+
+std::string TranslationProcessPool::translateModel(const std::string & path) throw(std::invalid_argument) {
+    BLOCKLY_TRACE_SPAN(span, "TranslationProcessPool::translateModel");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    return request(path, request_model, NULL);
+}
+
+std::string TranslationProcessPool::translateModel(const std::string & path, MachineFingerprint & fingerprint)
+    throw(std::invalid_argument)
+{
+    BLOCKLY_TRACE_SPAN(span, "TranslationProcessPool::translateModel");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    return request(path, request_model, &fingerprint);
+}
+
+std::future<std::string> TranslationProcessPool::translateModelAsync(const std::string & path) {
+    return std::async(std::launch::async, [this, path]() {
+        return translateModel(path);
+    });
+}
+
+size_t TranslationProcessPool::getRestartedWorkers() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return restartedWorkers;
+}
+
+std::string TranslationProcessPool::request(const std::string & path, RequestKind kind, MachineFingerprint * fingerprint)
+    throw(std::invalid_argument)
+{
+    size_t index;
+    Worker worker = acquireWorker(index);
+
+    //timeoutMs bounds the whole request, not every read of it
+    Deadline deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    const Deadline * requestDeadline = (timeoutMs > 0 ? &deadline : NULL);
+
+    //request: kind, fingerprint wanted, length and path;
+    //response: status, fingerprint, length and the image, the output of the job or the error message
+    uint8_t header[2] = {static_cast<uint8_t>(kind), static_cast<uint8_t>(fingerprint != NULL)};
+    uint32_t pathSize = path.size();
+    bool sent = writeAll(worker.socket, header, sizeof(header)) &&
+                writeAll(worker.socket, &pathSize, sizeof(pathSize)) &&
+                writeAll(worker.socket, path.data(), path.size());
+
+    uint8_t status = response_error;
+    uint64_t fingerprintFields[3] = {0, 0, 0};
+    uint32_t payloadSize = 0;
+    std::string payload;
+    bool received = sent &&
+                    readAll(worker.socket, &status, sizeof(status), requestDeadline) &&
+                    readAll(worker.socket, fingerprintFields, sizeof(fingerprintFields), requestDeadline) &&
+                    readAll(worker.socket, &payloadSize, sizeof(payloadSize), requestDeadline);
+    if (received) {
+        payload.resize(payloadSize);
+        received = readAll(worker.socket, &payload[0], payloadSize, requestDeadline);
+    }
+
+    if (!received) {
+        std::string reason = replaceWorker(index, worker);
+        releaseWorker(index);
+        throw(std::invalid_argument("TranslationProcessPool::request. worker lost translating " + path + ": " + reason));
+    }
+    releaseWorker(index);
+
+    if (status != response_ok) {
+        throw(std::invalid_argument("TranslationProcessPool::request. Exception ocurred " + payload));
+    }
+
+    if (fingerprint != NULL) {
+        *fingerprint = MachineFingerprint(fingerprintFields[0], fingerprintFields[1], fingerprintFields[2]);
+    }
+    return payload;
+}
+
+TranslationProcessPool::Worker TranslationProcessPool::acquireWorker(size_t & index) {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    idleCondition.wait(lock, [this]() {
+        return !idleWorkers.empty();
+    });
+
+    index = idleWorkers.back();
+    idleWorkers.pop_back();
+    return workers[index];
+}
+
+void TranslationProcessPool::releaseWorker(size_t index) {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        idleWorkers.push_back(index);
+    }
+    idleCondition.notify_one();
+}
+
+void TranslationProcessPool::startSpawner() throw(std::invalid_argument) {
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+        throw(std::invalid_argument("socketpair failed: " + std::string(std::strerror(errno))));
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(sockets[0]);
+        close(sockets[1]);
+        throw(std::invalid_argument("fork failed: " + std::string(std::strerror(errno))));
+    }
+
+    if (pid == 0) {
+        close(sockets[0]);
+        runSpawner(sockets[1], context, modelJob);
+        _exit(0);
+    }
+
+    close(sockets[1]);
+    spawnerPid = pid;
+    spawnerSocket = sockets[0];
+}
+
+TranslationProcessPool::Worker TranslationProcessPool::spawnWorker() throw(std::invalid_argument) {
+    std::lock_guard<std::mutex> lock(spawnerMutex);
+
+    //command: kind and pid; answer: the pid of the worker, or minus errno, with the socket of the worker attached
+    uint8_t command = spawn_worker;
+    int32_t pid = 0;
+    int32_t answer = 0;
+    int socket = -1;
+    if (!writeAll(spawnerSocket, &command, sizeof(command)) ||
+        !writeAll(spawnerSocket, &pid, sizeof(pid)) ||
+        !receiveDescriptor(spawnerSocket, answer, socket))
+    {
+        throw(std::invalid_argument("spawner process lost"));
+    }
+    if (answer <= 0 || socket < 0) {
+        if (socket >= 0) {
+            close(socket);
+        }
+        throw(std::invalid_argument("fork failed: " + std::string(std::strerror(-answer))));
+    }
+
+    Worker worker;
+    worker.pid = answer;
+    worker.socket = socket;
+    return worker;
+}
+
+int TranslationProcessPool::killWorker(pid_t pid) {
+    std::lock_guard<std::mutex> lock(spawnerMutex);
+
+    //command: kind and pid; answer: the status returned by waitpid
+    uint8_t command = kill_worker;
+    int32_t workerPid = pid;
+    int32_t status = 0;
+    if (!writeAll(spawnerSocket, &command, sizeof(command)) ||
+        !writeAll(spawnerSocket, &workerPid, sizeof(workerPid)) ||
+        !readAll(spawnerSocket, &status, sizeof(status), NULL))
+    {
+        return -1;
+    }
+    return status;
+}
+
+std::string TranslationProcessPool::replaceWorker(size_t index, const Worker & worker) {
+    //a slot whose replacement failed before has no process left
+    std::string reason = "no response";
+    if (worker.pid > 0) {
+        int status = killWorker(worker.pid);
+        close(worker.socket);
+
+        if (status < 0) {
+            reason = "spawner process lost";
+        } else if (WIFSIGNALED(status) && WTERMSIG(status) != SIGKILL) {
+            reason = "killed by signal " + std::to_string(WTERMSIG(status));
+        } else if (WIFEXITED(status)) {
+            reason = "exited with status " + std::to_string(WEXITSTATUS(status));
+        }
+    }
+
+    Worker replacement;
+    bool replaced = false;
+    try {
+        replacement = spawnWorker();
+        replaced = true;
+    } catch (std::exception & e) {
+        //the slot keeps no process, the next translation on it fails and tries again
+        replacement.pid = -1;
+        replacement.socket = -1;
+        reason += ", " + std::string(e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    workers[index] = replacement;
+    if (replaced) {
+        restartedWorkers++;
+    }
+    return reason;
+}
+
+void TranslationProcessPool::runSpawner(int socket, std::shared_ptr<const TranslationContext> context, const ModelJob & modelJob) {
+    for(;;) {
+        uint8_t command;
+        int32_t pid;
+        if (!readAll(socket, &command, sizeof(command), NULL) || !readAll(socket, &pid, sizeof(pid), NULL)) {
+            break;
+        }
+
+        if (command == spawn_worker) {
+            int sockets[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+                sendDescriptor(socket, -errno, -1);
+                continue;
+            }
+
+            pid_t workerPid = fork();
+            if (workerPid == 0) {
+                //the worker keeps only its own end
+                close(socket);
+                close(sockets[0]);
+                runWorker(sockets[1], context, modelJob);
+                _exit(0);
+            }
+
+            int forkError = errno;
+            close(sockets[1]);
+            bool sent = sendDescriptor(socket, workerPid > 0 ? workerPid : -forkError, workerPid > 0 ? sockets[0] : -1);
+            close(sockets[0]);
+            if (!sent) {
+                break;
+            }
+        } else if (command == kill_worker) {
+            int status = 0;
+            kill(pid, SIGKILL);
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+
+            int32_t answer = status;
+            if (!writeAll(socket, &answer, sizeof(answer))) {
+                break;
+            }
+        }
+    }
+
+    //the pool is gone, its workers leave as their sockets are closed
+    while (waitpid(-1, NULL, 0) > 0 || errno == EINTR) {}
+}
+
+void TranslationProcessPool::runWorker(int socket, std::shared_ptr<const TranslationContext> context, const ModelJob & modelJob) {
+    for(;;) {
+        uint8_t header[2];
+        uint32_t pathSize;
+        if (!readAll(socket, header, sizeof(header), NULL) || !readAll(socket, &pathSize, sizeof(pathSize), NULL)) {
+            return;
+        }
+        std::string path(pathSize, '\0');
+        if (pathSize > 0 && !readAll(socket, &path[0], pathSize, NULL)) {
+            return;
+        }
+
+        uint8_t status = response_ok;
+        uint64_t fingerprintFields[3] = {0, 0, 0};
+        std::string payload;
+        try {
+            BlocklyFluidicMachineTranslator translator(path, context);
+            translator.setFingerprintEnabled(header[1] != 0);
+            if (header[0] == request_model) {
+                //the model, and the Prolog engine behind it, never leave this process
+                BlocklyFluidicMachineTranslator::ModelMappingTuple modelMapping = translator.translateFile();
+                if (modelJob) {
+                    payload = modelJob(modelMapping);
+                }
+            } else {
+                std::shared_ptr<MachineIR> ir = translator.translateFileToIR();
+                payload = MachineIRImage::toBytes(*ir);
+            }
+
+            const MachineFingerprint & fingerprint = translator.getFingerprint();
+            fingerprintFields[0] = fingerprint.getValue();
+            fingerprintFields[1] = fingerprint.getNodes();
+            fingerprintFields[2] = fingerprint.getEdges();
+        } catch (std::exception & e) {
+            status = response_error;
+            payload = e.what();
+        }
+
+        uint32_t payloadSize = payload.size();
+        if (!writeAll(socket, &status, sizeof(status)) ||
+            !writeAll(socket, fingerprintFields, sizeof(fingerprintFields)) ||
+            !writeAll(socket, &payloadSize, sizeof(payloadSize)) ||
+            !writeAll(socket, payload.data(), payload.size()))
+        {
+            return;
+        }
+    }
+}
+
+bool TranslationProcessPool::sendDescriptor(int socket, int32_t value, int descriptor) {
+    iovec data;
+    data.iov_base = &value;
+    data.iov_len = sizeof(value);
+
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+
+    //the descriptor travels as SCM_RIGHTS ancillary data next to the value
+    char control[CMSG_SPACE(sizeof(int))];
+    if (descriptor >= 0) {
+        std::memset(control, 0, sizeof(control));
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        cmsghdr * header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(header), &descriptor, sizeof(int));
+    }
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(socket, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    return sent == sizeof(value);
+}
+
+bool TranslationProcessPool::receiveDescriptor(int socket, int32_t & value, int & descriptor) {
+    iovec data;
+    data.iov_base = &value;
+    data.iov_len = sizeof(value);
+
+    char control[CMSG_SPACE(sizeof(int))];
+    std::memset(control, 0, sizeof(control));
+
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do {
+        received = recvmsg(socket, &message, 0);
+    } while (received < 0 && errno == EINTR);
+
+    descriptor = -1;
+    cmsghdr * header = CMSG_FIRSTHDR(&message);
+    if (received > 0 && header != NULL && header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+        std::memcpy(&descriptor, CMSG_DATA(header), sizeof(int));
+    }
+    return received == sizeof(value);
+}
+
+bool TranslationProcessPool::writeAll(int socket, const void * data, size_t size) {
+    const char * bytes = static_cast<const char *>(data);
+    while(size > 0) {
+        //MSG_NOSIGNAL so a dead peer is an error instead of a SIGPIPE
+        ssize_t written = send(socket, bytes, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool TranslationProcessPool::readAll(int socket, void * data, size_t size, const Deadline * deadline) {
+    char * bytes = static_cast<char *>(data);
+    while(size > 0) {
+        if (deadline != NULL) {
+            auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(*deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                return false;
+            }
+            //rounded up so the last fraction of a millisecond is still waited
+            long long remainingMs = std::min<long long>((remaining.count() + 999) / 1000, std::numeric_limits<int>::max());
+
+            pollfd pollSocket;
+            pollSocket.fd = socket;
+            pollSocket.events = POLLIN;
+            pollSocket.revents = 0;
+
+            int ready = poll(&pollSocket, 1, static_cast<int>(remainingMs));
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            } else if (ready <= 0) {
+                return false;
+            }
+        }
+
+        ssize_t readed = recv(socket, bytes, size, 0);
+        if (readed < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        } else if (readed == 0) {
+            return false;
+        }
+        bytes += readed;
+        size -= readed;
+    }
+    return true;
+}
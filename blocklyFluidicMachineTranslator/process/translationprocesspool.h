@@ -0,0 +1,120 @@
+#ifndef TRANSLATIONPROCESSPOOL_H
+#define TRANSLATIONPROCESSPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "blocklyFluidicMachineTranslator/graph/machinefingerprint.h"
+#include "blocklyFluidicMachineTranslator/ir/machineir.h"
+#include "blocklyFluidicMachineTranslator/translationcontext.h"
+#include "blocklyfluidicmachinetranslator_global.h"
+
+// translations run in a pool of worker processes (unix only), so a crash reading or translating a file, or in the
+// Prolog engine of its model, only takes a worker down. A model and its engine can not leave the process that built
+// them, so translateModel() builds the model in the worker, runs there the ModelJob given to the constructor on it and
+// returns only the bytes the job returns. translate() stops at the MachineIR and sends it back as a MachineIRImage,
+// for a caller that needs the model itself and builds it in its own process with translateIR() or a FrozenMachine.
+// The fingerprint is only computed by the worker when it is asked for. A worker that dies or does not answer a
+// request within timeoutMs is replaced and the translation fails.
+// Every worker is forked by a single threaded spawner process, which the constructor forks before anything else, so
+// build the pool before starting other threads; afterwards any thread can ask the spawner for a replacement. Thread
+// safe, a translation waits when every worker is busy.
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT TranslationProcessPool
+{
+public:
+    // runs in the worker on the model just built, what it returns is sent back as the result of translateModel(). It
+    // is copied into the workers when the pool is built, so it can not depend on anything set up afterwards
+    typedef std::function<std::string(const BlocklyFluidicMachineTranslator::ModelMappingTuple & modelMapping)> ModelJob;
+
+    TranslationProcessPool(std::shared_ptr<const TranslationContext> context,
+                           size_t workersNumber,
+                           int timeoutMs = 0,
+                           ModelJob modelJob = ModelJob()) throw(std::invalid_argument);
+    virtual ~TranslationProcessPool();
+
+    std::shared_ptr<MachineIR> translate(const std::string & path) throw(std::invalid_argument);
+    std::shared_ptr<MachineIR> translate(const std::string & path, MachineFingerprint & fingerprint) throw(std::invalid_argument);
+    std::future<std::shared_ptr<MachineIR>> translateAsync(const std::string & path);
+
+    // without a ModelJob the model is still built and the result is empty
+    std::string translateModel(const std::string & path) throw(std::invalid_argument);
+    std::string translateModel(const std::string & path, MachineFingerprint & fingerprint) throw(std::invalid_argument);
+    std::future<std::string> translateModelAsync(const std::string & path);
+
+    size_t getWorkersNumber() const {
+        return workers.size();
+    }
+    size_t getRestartedWorkers() const;
+
+protected:
+    typedef std::chrono::steady_clock::time_point Deadline;
+
+    struct Worker {
+        pid_t pid;
+        int socket;
+    };
+
+    enum RequestKind {
+        request_ir = 0,
+        request_model = 1
+    };
+
+    enum ResponseStatus {
+        response_ok = 0,
+        response_error = 1
+    };
+
+    enum SpawnerCommand {
+        spawn_worker = 0,
+        kill_worker = 1
+    };
+
+    std::shared_ptr<const TranslationContext> context;
+    int timeoutMs;
+    ModelJob modelJob;
+
+    pid_t spawnerPid;
+    int spawnerSocket;
+    std::mutex spawnerMutex;
+
+    mutable std::mutex poolMutex;
+    std::condition_variable idleCondition;
+    // the slots are only read and written under poolMutex
+    std::vector<Worker> workers;
+    std::vector<size_t> idleWorkers;
+    size_t restartedWorkers;
+
+    // sends the request to an idle worker and returns the payload of its answer
+    std::string request(const std::string & path, RequestKind kind, MachineFingerprint * fingerprint) throw(std::invalid_argument);
+
+    Worker acquireWorker(size_t & index);
+    void releaseWorker(size_t index);
+
+    void startSpawner() throw(std::invalid_argument);
+    Worker spawnWorker() throw(std::invalid_argument);
+    int killWorker(pid_t pid);
+    std::string replaceWorker(size_t index, const Worker & worker);
+
+    static void runSpawner(int socket, std::shared_ptr<const TranslationContext> context, const ModelJob & modelJob);
+    static void runWorker(int socket, std::shared_ptr<const TranslationContext> context, const ModelJob & modelJob);
+
+    static bool sendDescriptor(int socket, int32_t value, int descriptor);
+    static bool receiveDescriptor(int socket, int32_t & value, int & descriptor);
+
+    static bool writeAll(int socket, const void * data, size_t size);
+    // deadline NULL waits forever
+    static bool readAll(int socket, void * data, size_t size, const Deadline * deadline);
+};
+
+#endif // TRANSLATIONPROCESSPOOL_H
@@ -0,0 +1,165 @@
+#include "phasecounters.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+PhaseCounters::Scope::Scope(PhaseCounters* counters, Phase phase) :
+    counters(counters), phase(phase)
+{
+    if (counters != NULL) {
+        begin = counters->read();
+    }
+}
+
+PhaseCounters::Scope::~Scope() {
+    if (counters != NULL) {
+        counters->accumulate(phase, begin);
+    }
+}
+
+PhaseCounters::PhaseCounters() :
+    blocks(0), edges(0)
+{
+    for(int i = 0; i < phases_number; i++) {
+        for(int j = 0; j < counters_number; j++) {
+            values[i][j] = 0;
+        }
+    }
+
+#ifdef __linux__
+    const uint64_t configs[counters_number] = {PERF_COUNT_HW_INSTRUCTIONS,
+                                               PERF_COUNT_HW_CPU_CYCLES,
+                                               PERF_COUNT_HW_CACHE_MISSES,
+                                               PERF_COUNT_HW_BRANCH_MISSES};
+    for(int i = 0; i < counters_number; i++) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        //this thread, any cpu, counting from now on
+        descriptors[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#else
+    for(int i = 0; i < counters_number; i++) {
+        descriptors[i] = -1;
+    }
+#endif
+}
+
+PhaseCounters::~PhaseCounters() {
+#ifdef __linux__
+    for(int i = 0; i < counters_number; i++) {
+        if (descriptors[i] >= 0) {
+            close(descriptors[i]);
+        }
+    }
+#endif
+}
+
+bool PhaseCounters::isAvailable() const {
+    for(int i = 0; i < counters_number; i++) {
+        if (descriptors[i] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PhaseCounters::isAvailable(Counter counter) const {
+    return descriptors[counter] >= 0;
+}
+
+std::vector<uint64_t> PhaseCounters::read() const {
+    std::vector<uint64_t> readed(counters_number, 0);
+#ifdef __linux__
+    for(int i = 0; i < counters_number; i++) {
+        uint64_t data[3];
+        if (descriptors[i] >= 0 && ::read(descriptors[i], data, sizeof(data)) == sizeof(data)) {
+            //the kernel may multiplex the counters, scale by the fraction of time this one was running
+            readed[i] = (data[2] > 0 && data[2] < data[1]) ?
+                        static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]) :
+                        data[0];
+        }
+    }
+#endif
+    return readed;
+}
+
+void PhaseCounters::accumulate(Phase phase, const std::vector<uint64_t> & begin) {
+    std::vector<uint64_t> end = read();
+    for(int i = 0; i < counters_number; i++) {
+        if (end[i] > begin[i]) {
+            values[phase][i] += end[i] - begin[i];
+        }
+    }
+}
+
+std::string PhaseCounters::toString() const {
+    std::stringstream stream;
+    if (!isAvailable()) {
+        stream << "hardware counters not available" << std::endl;
+        return stream.str();
+    }
+
+    for(int i = 0; i < phases_number; i++) {
+        stream << phaseToString((Phase) i) << ":";
+        for(int j = 0; j < counters_number; j++) {
+            stream << " " << counterToString((Counter) j) << "=";
+            if (isAvailable((Counter) j)) {
+                stream << values[i][j];
+                if (blocks > 0) {
+                    stream << " (" << (double) values[i][j] / blocks << "/block";
+                    if (edges > 0) {
+                        stream << ", " << (double) values[i][j] / edges << "/edge";
+                    }
+                    stream << ")";
+                }
+            } else {
+                stream << "n/a";
+            }
+        }
+        stream << std::endl;
+    }
+    return stream.str();
+}
+
+std::string PhaseCounters::phaseToString(Phase phase) {
+    switch (phase) {
+    case parse:
+        return "parse";
+    case configuration_blocks:
+        return "processConfigurationBlock";
+    case connection_map:
+        return "processConnectionMap";
+    case twins:
+        return "processTwins";
+    case model_construction:
+        return "model construction";
+    default:
+        return "unknown";
+    }
+}
+
+std::string PhaseCounters::counterToString(Counter counter) {
+    switch (counter) {
+    case instructions:
+        return "instructions";
+    case cycles:
+        return "cycles";
+    case cache_misses:
+        return "cache_misses";
+    case branch_misses:
+        return "branch_misses";
+    default:
+        return "unknown";
+    }
+}
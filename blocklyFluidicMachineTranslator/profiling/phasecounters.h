@@ -0,0 +1,80 @@
+#ifndef PHASECOUNTERS_H
+#define PHASECOUNTERS_H
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator_global.h"
+
+// hardware performance counters (instructions, cycles, cache misses and branch misses) accumulated per translation
+// phase, read through perf_event_open on Linux. The counters follow the thread that built the object, so it has to be
+// created by the thread that runs the translation. When a counter can not be opened (other systems, missing
+// permissions, virtual machines without a PMU...) it is reported as unavailable and the rest keep working.
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT PhaseCounters
+{
+public:
+    typedef enum Phase_ {
+        parse = 0,
+        configuration_blocks,
+        connection_map,
+        twins,
+        model_construction,
+        phases_number
+    } Phase;
+
+    typedef enum Counter_ {
+        instructions = 0,
+        cycles,
+        cache_misses,
+        branch_misses,
+        counters_number
+    } Counter;
+
+    // accumulates the counters of its own scope into phase, does nothing if counters is NULL
+    class Scope
+    {
+    public:
+        Scope(PhaseCounters* counters, Phase phase);
+        virtual ~Scope();
+
+    protected:
+        PhaseCounters* counters;
+        Phase phase;
+        std::vector<uint64_t> begin;
+    };
+
+    PhaseCounters();
+    virtual ~PhaseCounters();
+
+    bool isAvailable() const;
+    bool isAvailable(Counter counter) const;
+
+    uint64_t getValue(Phase phase, Counter counter) const {
+        return values[phase][counter];
+    }
+
+    void setWorkload(size_t blocks, size_t edges) {
+        this->blocks = blocks;
+        this->edges = edges;
+    }
+
+    // per phase totals and their ratios per block and per edge
+    std::string toString() const;
+
+    static std::string phaseToString(Phase phase);
+    static std::string counterToString(Counter counter);
+
+protected:
+    int descriptors[counters_number];
+    uint64_t values[phases_number][counters_number];
+
+    size_t blocks;
+    size_t edges;
+
+    std::vector<uint64_t> read() const;
+    void accumulate(Phase phase, const std::vector<uint64_t> & begin);
+};
+
+#endif // PHASECOUNTERS_H
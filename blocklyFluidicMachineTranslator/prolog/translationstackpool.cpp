@@ -0,0 +1,64 @@
+#include "translationstackpool.h"
+
+TranslationStackPool::TranslationStackPool(size_t maxIdle, size_t preallocated) :
+    state(std::make_shared<State>())
+{
+    state->maxIdle = maxIdle;
+    state->created = 0;
+
+    for(size_t i = 0; i < preallocated && i < maxIdle; i++) {
+        state->idle.push_back(std::unique_ptr<PrologTranslationStack>(new PrologTranslationStack()));
+        state->created++;
+    }
+}
+
+TranslationStackPool::~TranslationStackPool() {
+
+}
+
+std::shared_ptr<PrologTranslationStack> TranslationStackPool::lease() {
+    std::unique_ptr<PrologTranslationStack> stack;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->idle.empty()) {
+            stack = std::move(state->idle.back());
+            state->idle.pop_back();
+        } else {
+            state->created++;
+        }
+    }
+
+    //the engine is set up outside the lock so other leases are not blocked meanwhile
+    if (!stack) {
+        stack.reset(new PrologTranslationStack());
+    }
+
+    std::weak_ptr<State> weakState = state;
+    return std::shared_ptr<PrologTranslationStack>(stack.release(), [weakState](PrologTranslationStack* released) {
+        TranslationStackPool::release(weakState, released);
+    });
+}
+
+size_t TranslationStackPool::getIdleStacks() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->idle.size();
+}
+
+size_t TranslationStackPool::getCreatedStacks() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->created;
+}
+
+void TranslationStackPool::release(std::weak_ptr<State> weakState, PrologTranslationStack* stack) {
+    std::unique_ptr<PrologTranslationStack> owned(stack);
+
+    std::shared_ptr<State> state = weakState.lock();
+    if (state) {
+        owned->clear();
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->idle.size() < state->maxIdle) {
+            state->idle.push_back(std::move(owned));
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef TRANSLATIONSTACKPOOL_H
+#define TRANSLATIONSTACKPOOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <constraintengine/prologtranslationstack.h>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator_global.h"
+
+// keeps already initialized PrologTranslationStacks so a new model does not pay the set up of the engine. A leased
+// stack goes back to the pool, cleared, when the last shared_ptr to it (normally the FluidicMachineModel's) is released;
+// stacks released after the pool is gone, or when it already holds maxIdle of them, are simply destroyed.
+// Thread safe, can be shared between translators.
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT TranslationStackPool
+{
+public:
+    TranslationStackPool(size_t maxIdle, size_t preallocated = 0);
+    virtual ~TranslationStackPool();
+
+    std::shared_ptr<PrologTranslationStack> lease();
+
+    size_t getIdleStacks() const;
+    size_t getCreatedStacks() const;
+
+protected:
+    struct State {
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<PrologTranslationStack>> idle;
+        size_t maxIdle;
+        size_t created;
+    };
+
+    std::shared_ptr<State> state;
+
+    static void release(std::weak_ptr<State> weakState, PrologTranslationStack* stack);
+};
+
+#endif // TRANSLATIONSTACKPOOL_H
@@ -0,0 +1,28 @@
+#include "frozenmachine.h"
+
+FrozenMachine::FrozenMachine(
+        std::shared_ptr<const MachineIR> ir,
+        std::shared_ptr<PluginAbstractFactory> factory,
+        const MachineFingerprint & fingerprint)
+    throw(std::invalid_argument) :
+    ir(ir), fingerprint(fingerprint)
+{
+    if (!ir) {
+        throw(std::invalid_argument("FrozenMachine::FrozenMachine. null ir"));
+    }
+    payloads = MachineGraphBackEnd::prepare(*ir, factory);
+
+    const std::vector<std::string> & references = ir->getReferences();
+    variableIdMap.reserve(references.size());
+    for(const MachineIR::Node & node : ir->getNodes()) {
+        variableIdMap.insert(std::make_pair(references[node.reference], node.id));
+    }
+}
+
+FrozenMachine::~FrozenMachine() {
+
+}
+
+std::shared_ptr<MachineGraph> FrozenMachine::makeGraph() const throw(std::invalid_argument) {
+    return MachineGraphBackEnd::instantiate(*ir, payloads);
+}
@@ -0,0 +1,48 @@
+#ifndef FROZENMACHINE_H
+#define FROZENMACHINE_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fluidicmachinemodel/machinegraph.h>
+
+#include "blocklyFluidicMachineTranslator/graph/machinefingerprint.h"
+#include "blocklyFluidicMachineTranslator/ir/machinegraphbackend.h"
+#include "blocklyFluidicMachineTranslator/ir/machineir.h"
+#include "blocklyfluidicmachinetranslator_global.h"
+
+// translated machine frozen for sharing: the IR with the topology and the functions and truth tables of every node
+// already built. Nothing changes after construction, so any number of threads can read it and build their own
+// MachineGraph from it without locking; those graphs share the function objects instead of building them again.
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT FrozenMachine
+{
+public:
+    FrozenMachine(std::shared_ptr<const MachineIR> ir,
+                  std::shared_ptr<PluginAbstractFactory> factory,
+                  const MachineFingerprint & fingerprint) throw(std::invalid_argument);
+    virtual ~FrozenMachine();
+
+    // a new MachineGraph of the machine, private to the caller
+    std::shared_ptr<MachineGraph> makeGraph() const throw(std::invalid_argument);
+
+    const MachineIR & getIR() const {
+        return *ir;
+    }
+    const MachineFingerprint & getFingerprint() const {
+        return fingerprint;
+    }
+    const std::unordered_map<std::string, int> & getVariableIdMap() const {
+        return variableIdMap;
+    }
+
+protected:
+    const std::shared_ptr<const MachineIR> ir;
+    const MachineFingerprint fingerprint;
+    std::vector<MachineGraphBackEnd::NodePayload> payloads;
+    std::unordered_map<std::string, int> variableIdMap;
+};
+
+#endif // FROZENMACHINE_H
@@ -0,0 +1,34 @@
+#include "machineoverlay.h"
+
+MachineOverlay::MachineOverlay(std::shared_ptr<const FrozenMachine> frozen, std::shared_ptr<TranslationStackPool> stackPool)
+    throw(std::invalid_argument) :
+    frozen(frozen), stackPool(stackPool), materialized(false)
+{
+    if (!frozen) {
+        throw(std::invalid_argument("MachineOverlay::MachineOverlay. null frozen machine"));
+    }
+}
+
+MachineOverlay::~MachineOverlay() {
+
+}
+
+BlocklyFluidicMachineTranslator::ModelMappingTuple MachineOverlay::getModelMapping() throw(std::invalid_argument) {
+    if (!materialized) {
+        try {
+            BLOCKLY_TRACE_SPAN(span, "MachineOverlay::materialize");
+            modelMapping = BlocklyFluidicMachineTranslator::buildModelMapping(frozen->makeGraph(),
+                                                                              frozen->getIR().getHeader(),
+                                                                              stackPool);
+            materialized = true;
+        } catch (std::exception & e) {
+            throw(std::invalid_argument("MachineOverlay::getModelMapping. Exception ocurred " + std::string(e.what())));
+        }
+    }
+    return modelMapping;
+}
+
+void MachineOverlay::reset() {
+    modelMapping = BlocklyFluidicMachineTranslator::ModelMappingTuple();
+    materialized = false;
+}
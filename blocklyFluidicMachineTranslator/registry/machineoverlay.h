@@ -0,0 +1,50 @@
+#ifndef MACHINEOVERLAY_H
+#define MACHINEOVERLAY_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "blocklyFluidicMachineTranslator/registry/frozenmachine.h"
+#include "blocklyfluidicmachinetranslator_global.h"
+
+// view of one consumer over a shared FrozenMachine. The reads go to the frozen machine; the mutable state, the
+// MachineGraph, FluidicMachineModel and FluidicModelMapping of the consumer, is only built the first time
+// getModelMapping() is called (copy on write) and reset() drops it. Like the translator an overlay must not be used by
+// two threads at the same time, every consumer opens its own.
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT MachineOverlay
+{
+public:
+    MachineOverlay(std::shared_ptr<const FrozenMachine> frozen,
+                   std::shared_ptr<TranslationStackPool> stackPool = std::shared_ptr<TranslationStackPool>())
+        throw(std::invalid_argument);
+    virtual ~MachineOverlay();
+
+    BlocklyFluidicMachineTranslator::ModelMappingTuple getModelMapping() throw(std::invalid_argument);
+
+    bool isMaterialized() const {
+        return materialized;
+    }
+    void reset();
+
+    std::shared_ptr<const FrozenMachine> getFrozen() const {
+        return frozen;
+    }
+    const MachineIR & getIR() const {
+        return frozen->getIR();
+    }
+    const std::unordered_map<std::string, int> & getVariableIdMap() const {
+        return frozen->getVariableIdMap();
+    }
+
+protected:
+    std::shared_ptr<const FrozenMachine> frozen;
+    std::shared_ptr<TranslationStackPool> stackPool;
+
+    bool materialized;
+    BlocklyFluidicMachineTranslator::ModelMappingTuple modelMapping;
+};
+
+#endif // MACHINEOVERLAY_H
@@ -0,0 +1,80 @@
+#include "machineregistry.h"
+
+MachineRegistry::MachineRegistry(std::shared_ptr<const TranslationContext> context) :
+    context(context)
+{
+
+}
+
+MachineRegistry::~MachineRegistry() {
+
+}
+
+MachineRegistry::FrozenMachinePtr MachineRegistry::load(const std::string & path) throw(std::invalid_argument) {
+    std::promise<FrozenMachinePtr> promise;
+    std::shared_ptr<LoadEntry> entry;
+    bool translate = false;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto finded = machines.find(path);
+        if (finded != machines.end()) {
+            entry = finded->second;
+        } else {
+            entry = std::make_shared<LoadEntry>();
+            entry->future = promise.get_future().share();
+            machines.insert(std::make_pair(path, entry));
+            translate = true;
+        }
+    }
+
+    if (translate) {
+        try {
+            promise.set_value(freeze(path));
+        } catch (std::exception & e) {
+            //failed loads are not kept so the next load tries again
+            {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                auto finded = machines.find(path);
+                if (finded != machines.end() && finded->second == entry) {
+                    machines.erase(finded);
+                }
+            }
+            promise.set_exception(std::current_exception());
+        }
+    }
+
+    try {
+        return entry->future.get();
+    } catch (std::exception & e) {
+        throw(std::invalid_argument("MachineRegistry::load. Exception ocurred " + std::string(e.what())));
+    }
+}
+
+MachineOverlay MachineRegistry::open(const std::string & path) throw(std::invalid_argument) {
+    return MachineOverlay(load(path), context->getStackPool());
+}
+
+void MachineRegistry::evict(const std::string & path) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    machines.erase(path);
+}
+
+void MachineRegistry::clear() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    machines.clear();
+}
+
+size_t MachineRegistry::size() const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return machines.size();
+}
+
+MachineRegistry::FrozenMachinePtr MachineRegistry::freeze(const std::string & path) throw(std::invalid_argument) {
+    BLOCKLY_TRACE_SPAN(span, "MachineRegistry::freeze");
+    BLOCKLY_TRACE_ARG(span, "path", path);
+
+    BlocklyFluidicMachineTranslator translator(path, context);
+    translator.setFingerprintEnabled(true);
+    std::shared_ptr<const MachineIR> ir = translator.translateFileToIR();
+    return std::make_shared<const FrozenMachine>(ir, context->getFactory(), translator.getFingerprint());
+}
@@ -0,0 +1,50 @@
+#ifndef MACHINEREGISTRY_H
+#define MACHINEREGISTRY_H
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "blocklyFluidicMachineTranslator/registry/frozenmachine.h"
+#include "blocklyFluidicMachineTranslator/registry/machineoverlay.h"
+#include "blocklyFluidicMachineTranslator/translationcontext.h"
+#include "blocklyfluidicmachinetranslator_global.h"
+
+// machines of the process translated once and shared. The first load of a path translates it and freezes the result,
+// the following ones (also the ones that arrive while that translation is running) get the same FrozenMachine. A path
+// whose file changes must be evicted to be translated again. Thread safe.
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT MachineRegistry
+{
+public:
+    typedef std::shared_ptr<const FrozenMachine> FrozenMachinePtr;
+
+    MachineRegistry(std::shared_ptr<const TranslationContext> context);
+    virtual ~MachineRegistry();
+
+    FrozenMachinePtr load(const std::string & path) throw(std::invalid_argument);
+    // a new overlay of the machine for one consumer, its models take the stacks from the pool of the context
+    MachineOverlay open(const std::string & path) throw(std::invalid_argument);
+
+    void evict(const std::string & path);
+    void clear();
+    size_t size() const;
+
+protected:
+    //the entries are compared by address, so a failed load only removes its own entry
+    struct LoadEntry {
+        std::shared_future<FrozenMachinePtr> future;
+    };
+
+    std::shared_ptr<const TranslationContext> context;
+
+    mutable std::mutex registryMutex;
+    std::unordered_map<std::string, std::shared_ptr<LoadEntry>> machines;
+
+    FrozenMachinePtr freeze(const std::string & path) throw(std::invalid_argument);
+};
+
+#endif // MACHINEREGISTRY_H
@@ -0,0 +1,109 @@
+#include "tracer.h"
+
+#include <fstream>
+
+std::atomic<bool> Tracer::recording(false);
+std::mutex Tracer::eventsMutex;
+std::vector<Tracer::Event> Tracer::events;
+std::atomic<long long> Tracer::origin(0);
+std::atomic<int> Tracer::nextThreadId(1);
+
+bool Tracer::isCompiledIn() {
+#ifdef BLOCKLYTRANSLATOR_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Tracer::start() {
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    events.clear();
+    origin = clockMicroseconds();
+    recording = true;
+}
+
+void Tracer::stop() {
+    recording = false;
+}
+
+int Tracer::currentThreadId() {
+    //small sequential ids read better in the trace viewers than the hashed std::thread::id
+    thread_local int threadId = nextThreadId++;
+    return threadId;
+}
+
+long long Tracer::now() {
+    return clockMicroseconds() - origin.load(std::memory_order_relaxed);
+}
+
+long long Tracer::clockMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::record(Event && event) {
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    if (recording) {
+        events.push_back(std::move(event));
+    }
+}
+
+void Tracer::write(std::ostream & out) {
+    std::lock_guard<std::mutex> lock(eventsMutex);
+
+    out << "{\"traceEvents\":[";
+    for(size_t i = 0; i < events.size(); i++) {
+        const Event & event = events[i];
+
+        nlohmann::json eventObj;
+        eventObj["name"] = event.name;
+        eventObj["cat"] = "translator";
+        eventObj["ph"] = "X";
+        eventObj["ts"] = event.begin;
+        eventObj["dur"] = event.duration;
+        eventObj["pid"] = 1;
+        eventObj["tid"] = event.threadId;
+        if (!event.args.is_null()) {
+            eventObj["args"] = event.args;
+        }
+
+        out << (i > 0 ? ",\n" : "\n") << eventObj.dump();
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void Tracer::writeFile(const std::string & path) throw(std::invalid_argument) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw(std::invalid_argument("Tracer::writeFile. unable to open " + path));
+    }
+    write(out);
+}
+
+TraceSpan::TraceSpan(const char* name) {
+    active = Tracer::isRecording();
+    if (active) {
+        event.name = name;
+        event.threadId = Tracer::currentThreadId();
+        event.begin = Tracer::now();
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (active) {
+        event.duration = Tracer::now() - event.begin;
+        Tracer::record(std::move(event));
+    }
+}
+
+void TraceSpan::addArg(const std::string & key, const std::string & value) {
+    if (active) {
+        event.args[key] = value;
+    }
+}
+
+void TraceSpan::addArg(const std::string & key, long long value) {
+    if (active) {
+        event.args[key] = value;
+    }
+}
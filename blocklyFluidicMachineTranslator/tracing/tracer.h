@@ -0,0 +1,80 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator_global.h"
+
+// span tracing of the translation internals in the chrome trace event format, the written files can be opened with
+// chrome://tracing or Perfetto. The spans are only compiled in with BLOCKLYTRANSLATOR_TRACING (CONFIG += tracing),
+// otherwise the BLOCKLY_TRACE_* macros expand to nothing; even when compiled in nothing is recorded until start().
+#ifdef BLOCKLYTRANSLATOR_TRACING
+#define BLOCKLY_TRACE_SPAN(span, name) TraceSpan span(name)
+#define BLOCKLY_TRACE_ARG(span, key, value) span.addArg(key, value)
+#else
+#define BLOCKLY_TRACE_SPAN(span, name)
+#define BLOCKLY_TRACE_ARG(span, key, value)
+#endif
+
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT Tracer
+{
+public:
+    struct Event {
+        std::string name;
+        long long begin;
+        long long duration;
+        int threadId;
+        nlohmann::json args;
+    };
+
+    virtual ~Tracer(){}
+
+    static bool isCompiledIn();
+
+    static void start();
+    static void stop();
+    static bool isRecording() {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    static long long now();
+    static long long clockMicroseconds();
+    static int currentThreadId();
+    static void record(Event && event);
+
+    static void write(std::ostream & out);
+    static void writeFile(const std::string & path) throw(std::invalid_argument);
+
+protected:
+    static std::atomic<bool> recording;
+    static std::mutex eventsMutex;
+    static std::vector<Event> events;
+    // microseconds of the steady clock when start() was called, atomic because the spans read it without the lock
+    static std::atomic<long long> origin;
+    static std::atomic<int> nextThreadId;
+};
+
+// times its own scope and records it as a complete event when it is destroyed
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT TraceSpan
+{
+public:
+    TraceSpan(const char* name);
+    virtual ~TraceSpan();
+
+    void addArg(const std::string & key, const std::string & value);
+    void addArg(const std::string & key, long long value);
+
+protected:
+    bool active;
+    Tracer::Event event;
+};
+
+#endif // TRACER_H
@@ -0,0 +1,15 @@
+#include "translationcontext.h"
+
+TranslationContext::TranslationContext(
+        std::shared_ptr<PluginAbstractFactory> factory,
+        NodeReordering::Ordering nodeOrdering,
+        std::shared_ptr<TranslationStackPool> stackPool,
+        const TranslationLimits & limits) :
+    factory(factory), nodeOrdering(nodeOrdering), stackPool(stackPool), limits(limits)
+{
+
+}
+
+TranslationContext::~TranslationContext() {
+
+}
@@ -0,0 +1,45 @@
+#ifndef TRANSLATIONCONTEXT_H
+#define TRANSLATIONCONTEXT_H
+
+#include <memory>
+
+#include <commonmodel/functions/function.h>
+
+#include "blocklyFluidicMachineTranslator/graph/nodereordering.h"
+#include "blocklyFluidicMachineTranslator/prolog/translationstackpool.h"
+#include "blocklyFluidicMachineTranslator/translationlimits.h"
+#include "blocklyfluidicmachinetranslator_global.h"
+
+// configuration shared by every translation: the plugin factory and the default options. It is immutable once built so
+// a single context can be shared by translators running in different threads without any locking. The models take
+// their translation stacks from stackPool when there is one (the pool itself is thread safe).
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT TranslationContext
+{
+public:
+    TranslationContext(std::shared_ptr<PluginAbstractFactory> factory,
+                       NodeReordering::Ordering nodeOrdering = NodeReordering::reference_order,
+                       std::shared_ptr<TranslationStackPool> stackPool = std::shared_ptr<TranslationStackPool>(),
+                       const TranslationLimits & limits = TranslationLimits());
+    virtual ~TranslationContext();
+
+    std::shared_ptr<PluginAbstractFactory> getFactory() const {
+        return factory;
+    }
+    NodeReordering::Ordering getNodeOrdering() const {
+        return nodeOrdering;
+    }
+    std::shared_ptr<TranslationStackPool> getStackPool() const {
+        return stackPool;
+    }
+    const TranslationLimits & getLimits() const {
+        return limits;
+    }
+
+protected:
+    const std::shared_ptr<PluginAbstractFactory> factory;
+    const NodeReordering::Ordering nodeOrdering;
+    const std::shared_ptr<TranslationStackPool> stackPool;
+    const TranslationLimits limits;
+};
+
+#endif // TRANSLATIONCONTEXT_H
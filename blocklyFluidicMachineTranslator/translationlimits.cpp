@@ -0,0 +1,29 @@
+#include "translationlimits.h"
+
+#include <limits>
+
+TranslationLimits::TranslationLimits() :
+    maxInputBytes(512 * 1024 * 1024),
+    maxBlocks(100000),
+    maxPinsPerNode(1024),
+    maxParamsPerPlugin(1024),
+    maxReferenceDepth(64),
+    maxNestingDepth(128),
+    maxEdges(1000000),
+    maxEstimatedMemory(static_cast<size_t>(2) * 1024 * 1024 * 1024)
+{
+
+}
+
+TranslationLimits TranslationLimits::unlimited() {
+    TranslationLimits limits;
+    limits.maxInputBytes = std::numeric_limits<size_t>::max();
+    limits.maxBlocks = std::numeric_limits<size_t>::max();
+    limits.maxPinsPerNode = std::numeric_limits<size_t>::max();
+    limits.maxParamsPerPlugin = std::numeric_limits<size_t>::max();
+    limits.maxReferenceDepth = std::numeric_limits<size_t>::max();
+    limits.maxNestingDepth = std::numeric_limits<size_t>::max();
+    limits.maxEdges = std::numeric_limits<size_t>::max();
+    limits.maxEstimatedMemory = std::numeric_limits<size_t>::max();
+    return limits;
+}
@@ -0,0 +1,47 @@
+#ifndef TRANSLATIONLIMITS_H
+#define TRANSLATIONLIMITS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include "blocklyfluidicmachinetranslator_global.h"
+
+// budgets enforced while the input is read, so a malformed or hostile input is rejected as soon as it asks for more
+// than allowed instead of after all the work has been done. A translation exceeding any of them fails with an
+// invalid_argument and leaves the translator ready for the next one. The defaults are far above any real machine,
+// unlimited() disables every check.
+struct BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT TranslationLimits
+{
+    // decompressed bytes of the input document
+    size_t maxInputBytes;
+    size_t maxBlocks;
+    size_t maxPinsPerNode;
+    size_t maxParamsPerPlugin;
+    // nested part_copy references
+    size_t maxReferenceDepth;
+    // nested objects and arrays of the input documents, and nested number_list and text_list inputs
+    size_t maxNestingDepth;
+    size_t maxEdges;
+    // rough estimation of the memory taken by the translation state, see BlocklyFluidicMachineTranslator
+    size_t maxEstimatedMemory;
+
+    TranslationLimits();
+
+    static TranslationLimits unlimited();
+
+    // a json number as the value of a check, the negative ones count as zero
+    static size_t toValue(double number) {
+        return (number > 0 ? static_cast<size_t>(std::min(number, 1e18)) : 0);
+    }
+
+    static void check(size_t value, size_t limit, const std::string & what) throw(std::invalid_argument) {
+        if (value > limit) {
+            throw(std::invalid_argument("translation limit exceeded, " + what + " " + std::to_string(value) +
+                                        " > " + std::to_string(limit)));
+        }
+    }
+};
+
+#endif // TRANSLATIONLIMITS_H
@@ -0,0 +1,66 @@
+#include "translationmonitor.h"
+
+TranslationMonitor::TranslationMonitor() :
+    cancelled(false), hasDeadline(false), processedBlocks(0), totalBlocks(0)
+{
+
+}
+
+TranslationMonitor::~TranslationMonitor() {
+
+}
+
+void TranslationMonitor::setProgressCallback(ProgressCallback callback) {
+    std::lock_guard<std::mutex> lock(configurationMutex);
+    progressCallback = callback;
+}
+
+void TranslationMonitor::setDeadline(const std::chrono::steady_clock::time_point & deadline) {
+    std::lock_guard<std::mutex> lock(configurationMutex);
+    this->deadline = deadline;
+    hasDeadline = true;
+}
+
+void TranslationMonitor::setTimeout(const std::chrono::milliseconds & timeout) {
+    setDeadline(std::chrono::steady_clock::now() + timeout);
+}
+
+void TranslationMonitor::cancel() {
+    cancelled = true;
+}
+
+bool TranslationMonitor::isCancelled() const {
+    return cancelled;
+}
+
+bool TranslationMonitor::isDeadlineExpired() const {
+    if (hasDeadline) {
+        std::lock_guard<std::mutex> lock(configurationMutex);
+        return std::chrono::steady_clock::now() >= deadline;
+    }
+    return false;
+}
+
+void TranslationMonitor::checkInterruption() const throw(TranslationInterruptedException) {
+    if (cancelled) {
+        throw(TranslationInterruptedException("translation cancelled after " + std::to_string(processedBlocks) +
+                                              " of " + std::to_string(totalBlocks) + " blocks"));
+    } else if (isDeadlineExpired()) {
+        throw(TranslationInterruptedException("translation deadline expired after " + std::to_string(processedBlocks) +
+                                              " of " + std::to_string(totalBlocks) + " blocks"));
+    }
+}
+
+void TranslationMonitor::reportProgress(int processed, int total) {
+    processedBlocks = processed;
+    totalBlocks = total;
+
+    ProgressCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(configurationMutex);
+        callback = progressCallback;
+    }
+    if (callback) {
+        callback(processed, total);
+    }
+}
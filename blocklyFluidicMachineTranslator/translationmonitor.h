@@ -0,0 +1,63 @@
+#ifndef TRANSLATIONMONITOR_H
+#define TRANSLATIONMONITOR_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include "blocklyfluidicmachinetranslator_global.h"
+
+// thrown by a translation whose TranslationMonitor was cancelled or whose deadline expired
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT TranslationInterruptedException : public std::runtime_error
+{
+public:
+    TranslationInterruptedException(const std::string & what) :
+        std::runtime_error(what)
+    {}
+    virtual ~TranslationInterruptedException(){}
+};
+
+// shared between a running translation and its caller. Cancellation and deadlines are cooperative:
+// the translation polls the monitor between configuration blocks and while connecting the nodes.
+class BLOCKLYFLUIDICMACHINETRANSLATORSHARED_EXPORT TranslationMonitor
+{
+public:
+    typedef std::function<void(int processedBlocks, int totalBlocks)> ProgressCallback;
+
+    TranslationMonitor();
+    virtual ~TranslationMonitor();
+
+    void setProgressCallback(ProgressCallback callback);
+    void setDeadline(const std::chrono::steady_clock::time_point & deadline);
+    void setTimeout(const std::chrono::milliseconds & timeout);
+
+    void cancel();
+
+    bool isCancelled() const;
+    bool isDeadlineExpired() const;
+
+    int getProcessedBlocks() const {
+        return processedBlocks;
+    }
+    int getTotalBlocks() const {
+        return totalBlocks;
+    }
+
+    void checkInterruption() const throw(TranslationInterruptedException);
+    void reportProgress(int processed, int total);
+
+protected:
+    std::atomic<bool> cancelled;
+    std::atomic<bool> hasDeadline;
+    std::atomic<int> processedBlocks;
+    std::atomic<int> totalBlocks;
+
+    mutable std::mutex configurationMutex;
+    std::chrono::steady_clock::time_point deadline;
+    ProgressCallback progressCallback;
+};
+
+#endif // TRANSLATIONMONITOR_H
@@ -0,0 +1,108 @@
+#include "machinegenerator.h"
+
+using json = nlohmann::json;
+
+json MachineGenerator::makeMachine() {
+    json machine;
+    machine["default_rate"] = 1;
+    machine["default_rate_volume_units"] = "ml";
+    machine["default_rate_time_units"] = "s";
+    machine["integer_precission"] = 3;
+    machine["decimal_precission"] = 2;
+    machine["connections"] = json::array();
+    return machine;
+}
+
+json MachineGenerator::makeReference(const std::string & reference) {
+    json referenceObj;
+    referenceObj["reference"] = reference;
+    return referenceObj;
+}
+
+json MachineGenerator::makeContainer(
+        const std::string & reference,
+        bool open,
+        const std::vector<int> & inPorts,
+        const std::vector<int> & outPorts,
+        const std::vector<json> & ports)
+{
+    json block;
+    block["reference"] = reference;
+    block["type"] = (open ? "OPEN_CONTAINER" : "CLOSE_CONTAINER");
+    block["functions"] = {{"minVolume", 0}, {"minVolumeUnits", "ml"}, {"maxVolume", 10}, {"maxVolumeUnits", "ml"}};
+    block["extra_functions"] = {{"type", "functions_list"}, {"functionsList", json::array()}};
+    block["number_pins"] = ports.size();
+    block["in_ports"] = inPorts;
+    block["out_ports"] = outPorts;
+    for(size_t i = 0; i < ports.size(); i++) {
+        block["port" + std::to_string(i + 1)] = ports[i];
+    }
+    return block;
+}
+
+json MachineGenerator::makePump(const std::string & reference, const json & inPort, const json & outPort) {
+    json block;
+    block["reference"] = reference;
+    block["type"] = "PUMP";
+    block["functions"] = {{"block_type", "pump"}, {"type", "t"}, {"paramsNumber", 0},
+                          {"minRange", 1}, {"minRangeVolumeUnits", "ml"}, {"minRangeTimeUnits", "s"},
+                          {"maxRange", 2}, {"maxRangeVolumeUnits", "ml"}, {"maxRangeTimeUnits", "s"},
+                          {"reversible", false}};
+    block["number_pins"] = 2;
+    block["in_ports"] = {1};
+    block["out_ports"] = {2};
+    block["port1"] = inPort;
+    block["port2"] = outPort;
+    return block;
+}
+
+json MachineGenerator::makeValve(
+        const std::string & reference,
+        const std::vector<int> & inPorts,
+        const std::vector<int> & outPorts,
+        const std::vector<json> & ports,
+        const json & truthTable)
+{
+    json block;
+    block["reference"] = reference;
+    block["type"] = "VALVE";
+    block["functions"] = {{"block_type", "valve"}, {"type", "t"}, {"paramsNumber", 0}, {"truthTable", truthTable}};
+    block["number_pins"] = ports.size();
+    block["in_ports"] = inPorts;
+    block["out_ports"] = outPorts;
+    for(size_t i = 0; i < ports.size(); i++) {
+        block["port" + std::to_string(i + 1)] = ports[i];
+    }
+    return block;
+}
+
+json MachineGenerator::makeChain(int pumps) {
+    json machine = makeMachine();
+    json & connections = machine["connections"];
+
+    auto container = [](int i) { return "c" + std::to_string(i); };
+    auto pump = [](int i) { return "p" + std::to_string(i); };
+
+    connections.push_back(makeContainer(container(0), true, {}, {1}, {makeReference(pump(0))}));
+    for(int i = 0; i < pumps; i++) {
+        connections.push_back(makePump(pump(i), makeReference(container(i)), makeReference(container(i + 1))));
+        if (i + 1 < pumps) {
+            connections.push_back(makeContainer(container(i + 1), false, {1}, {2},
+                                                {makeReference(pump(i)), makeReference(pump(i + 1))}));
+        }
+    }
+    connections.push_back(makeContainer(container(pumps), false, {1}, {}, {makeReference(pump(pumps - 1))}));
+    machine["number_blocks"] = connections.size();
+    return machine;
+}
+
+void MachineGenerator::writeFile(const json & machine, const std::string & path) throw(std::invalid_argument) {
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw(std::invalid_argument("MachineGenerator::writeFile. unable to open " + path));
+    }
+    out << machine.dump();
+    if (!out.good()) {
+        throw(std::invalid_argument("MachineGenerator::writeFile. error writing " + path));
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef MACHINEGENERATOR_H
+#define MACHINEGENERATOR_H
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+// builds synthetic machines in the json format read by BlocklyFluidicMachineTranslator, so the benchmarks and the
+// tests can size their inputs without shipping large files. Every block gets the functions of a plain container or
+// pump, the ports are listed in the order of the references passed.
+class MachineGenerator
+{
+public:
+    // header with an empty connections list
+    static nlohmann::json makeMachine();
+
+    static nlohmann::json makeReference(const std::string & reference);
+    static nlohmann::json makeContainer(const std::string & reference,
+                                        bool open,
+                                        const std::vector<int> & inPorts,
+                                        const std::vector<int> & outPorts,
+                                        const std::vector<nlohmann::json> & ports);
+    static nlohmann::json makePump(const std::string & reference, const nlohmann::json & inPort, const nlohmann::json & outPort);
+    // truthTable is the list of {"position", "connected_pins"} rows
+    static nlohmann::json makeValve(const std::string & reference,
+                                    const std::vector<int> & inPorts,
+                                    const std::vector<int> & outPorts,
+                                    const std::vector<nlohmann::json> & ports,
+                                    const nlohmann::json & truthTable);
+
+    // open container -> pump -> close container -> pump -> ... -> close container, with the given number of pumps
+    static nlohmann::json makeChain(int pumps);
+
+    static void writeFile(const nlohmann::json & machine, const std::string & path) throw(std::invalid_argument);
+};
+
+#endif // MACHINEGENERATOR_H
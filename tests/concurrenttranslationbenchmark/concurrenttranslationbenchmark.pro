@@ -0,0 +1,8 @@
+# measures how the translation throughput scales with translators sharing one TranslationContext
+
+include(../tests.pri)
+
+TARGET = concurrenttranslationbenchmark
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "tests/common/machinegenerator.h"
+
+// usage: concurrenttranslationbenchmark [--counters] [maxThreads=hardware threads] [translations=200] [pumps=500]
+//
+// translates the same machine "translations" times with 1, 2, 4... maxThreads threads. Every translation uses its
+// own translator and all of them share one TranslationContext, the speedup is the throughput against one thread.
+// With --counters one more translation runs afterwards with the hardware counters enabled and prints them per phase.
+
+namespace {
+
+// seconds needed to run all the translations with threadsNumber threads
+double measure(const std::string & path,
+               std::shared_ptr<const TranslationContext> context,
+               int threadsNumber,
+               int translations)
+{
+    std::atomic<int> nextTranslation(0);
+    std::vector<std::thread> threads;
+
+    auto begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < threadsNumber; i++) {
+        threads.emplace_back([&path, context, translations, &nextTranslation]() {
+            while (nextTranslation.fetch_add(1) < translations) {
+                BlocklyFluidicMachineTranslator translator(path, context);
+                translator.translateFile();
+            }
+        });
+    }
+    for(std::thread & thread : threads) {
+        thread.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    bool counters = false;
+    std::vector<char*> args;
+    for(int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--counters") {
+            counters = true;
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    int maxThreads = (args.size() > 0 ? std::atoi(args[0]) : std::max<int>(std::thread::hardware_concurrency(), 1));
+    int translations = (args.size() > 1 ? std::atoi(args[1]) : 200);
+    int pumps = (args.size() > 2 ? std::atoi(args[2]) : 500);
+
+    std::string path = "concurrenttranslationbenchmark.json";
+    try {
+        MachineGenerator::writeFile(MachineGenerator::makeChain(pumps), path);
+
+        std::shared_ptr<const TranslationContext> context =
+                std::make_shared<const TranslationContext>(std::shared_ptr<PluginAbstractFactory>(),
+                                                           NodeReordering::reference_order,
+                                                           std::make_shared<TranslationStackPool>(maxThreads));
+        //warms the function tables and the stack pool
+        measure(path, context, 1, 1);
+
+        std::printf("translations: %d, pumps: %d\n", translations, pumps);
+        double single = 0;
+        for(int threadsNumber = 1; threadsNumber <= maxThreads; threadsNumber *= 2) {
+            double seconds = measure(path, context, threadsNumber, translations);
+            if (threadsNumber == 1) {
+                single = seconds;
+            }
+            std::printf("threads %3d: %.3f s, %.1f translations/s, speedup %.2f\n",
+                        threadsNumber, seconds, translations / seconds, single / seconds);
+        }
+
+        if (counters) {
+            //kept out of the timings, the counters are read at every phase change
+            BlocklyFluidicMachineTranslator translator(path, context);
+            translator.setHardwareCountersEnabled(true);
+            translator.translateFile();
+            std::printf("%s", translator.getPhaseCounters()->toString().c_str());
+        }
+    } catch (std::exception & e) {
+        std::fprintf(stderr, "concurrenttranslationbenchmark: %s\n", e.what());
+        std::remove(path.c_str());
+        return 1;
+    }
+    std::remove(path.c_str());
+    return 0;
+}
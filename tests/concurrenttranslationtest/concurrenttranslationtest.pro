@@ -0,0 +1,9 @@
+# runs several translators at the same time over one shared TranslationContext
+
+include(../tests.pri)
+
+TARGET = concurrenttranslationtest
+CONFIG += testcase
+
+SOURCES += \
+    main.cpp
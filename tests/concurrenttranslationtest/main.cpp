@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "tests/common/machinegenerator.h"
+
+// every thread translates all the machines several times with its own translator and a TranslationContext shared by
+// all of them; each translation must give the same fingerprint as the sequential one
+
+namespace {
+
+const int THREADS_NUMBER = 8;
+const int MACHINES_NUMBER = 6;
+const int ROUNDS = 20;
+
+std::string machinePath(int machine) {
+    return "concurrenttranslationtest_" + std::to_string(machine) + ".json";
+}
+
+std::shared_ptr<const TranslationContext> makeContext() {
+    return std::make_shared<const TranslationContext>(std::shared_ptr<PluginAbstractFactory>(),
+                                                      NodeReordering::reference_order,
+                                                      std::make_shared<TranslationStackPool>(THREADS_NUMBER));
+}
+
+MachineFingerprint translate(const std::string & path, std::shared_ptr<const TranslationContext> context) {
+    BlocklyFluidicMachineTranslator translator(path, context);
+    MachineFingerprint fingerprint;
+    translator.translateFile(fingerprint);
+    return fingerprint;
+}
+
+}
+
+int main() {
+    int failures = 0;
+    try {
+        std::shared_ptr<const TranslationContext> context = makeContext();
+
+        std::vector<MachineFingerprint> expected;
+        for(int machine = 0; machine < MACHINES_NUMBER; machine++) {
+            MachineGenerator::writeFile(MachineGenerator::makeChain(10 + 25 * machine), machinePath(machine));
+            expected.push_back(translate(machinePath(machine), context));
+        }
+
+        //each thread starts on a different machine so the same file is translated by several threads at once
+        std::vector<int> mismatches(THREADS_NUMBER, 0);
+        std::vector<std::string> errors(THREADS_NUMBER);
+        std::vector<std::thread> threads;
+        for(int thread = 0; thread < THREADS_NUMBER; thread++) {
+            threads.emplace_back([thread, context, &expected, &mismatches, &errors]() {
+                try {
+                    for(int round = 0; round < ROUNDS; round++) {
+                        for(int i = 0; i < MACHINES_NUMBER; i++) {
+                            int machine = (thread + i) % MACHINES_NUMBER;
+                            if (translate(machinePath(machine), context) != expected[machine]) {
+                                mismatches[thread]++;
+                            }
+                        }
+                    }
+                } catch (std::exception & e) {
+                    errors[thread] = e.what();
+                }
+            });
+        }
+        for(std::thread & thread : threads) {
+            thread.join();
+        }
+
+        for(int thread = 0; thread < THREADS_NUMBER; thread++) {
+            if (mismatches[thread] > 0) {
+                std::fprintf(stderr, "FAILED: thread %d got %d different machines\n", thread, mismatches[thread]);
+                failures++;
+            }
+            if (!errors[thread].empty()) {
+                std::fprintf(stderr, "FAILED: thread %d: %s\n", thread, errors[thread].c_str());
+                failures++;
+            }
+        }
+    } catch (std::exception & e) {
+        std::fprintf(stderr, "FAILED: %s\n", e.what());
+        failures++;
+    }
+
+    for(int machine = 0; machine < MACHINES_NUMBER; machine++) {
+        std::remove(machinePath(machine).c_str());
+    }
+
+    if (failures > 0) {
+        std::fprintf(stderr, "concurrenttranslationtest: %d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("concurrenttranslationtest: passed\n");
+    return 0;
+}
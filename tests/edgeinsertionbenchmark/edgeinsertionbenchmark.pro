@@ -0,0 +1,8 @@
+# compares the buffered edge insertion of the translator against the incremental path it replaced
+
+include(../tests.pri)
+
+TARGET = edgeinsertionbenchmark
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <unordered_set>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "tests/common/machinegenerator.h"
+
+// usage: edgeinsertionbenchmark [pumps] [repetitions]
+//
+// connects the same machine with processConnectionMap + addEdges, which collect the edges into a buffer and hand
+// them to the graph afterwards, and with the incremental path they replaced, where every edge was connected as
+// soon as it was found and the processed nodes were kept in a hash set. MachineGraph has no bulk insertion, so both
+// paths end in one connectNodes per edge; the difference is the bookkeeping around it.
+
+namespace {
+
+class EdgeInsertionBenchmark : public BlocklyFluidicMachineTranslator
+{
+public:
+    EdgeInsertionBenchmark(const std::string & path) :
+        BlocklyFluidicMachineTranslator(path, std::shared_ptr<PluginAbstractFactory>())
+    {
+        setLimits(TranslationLimits::unlimited());
+        edgesNumber = 0;
+    }
+
+    // translates the blocks once, every measure starts from a copy of the resulting connection maps
+    void prepare() {
+        resetState();
+        nlohmann::json js;
+        readFile(js);
+        renumberNodes();
+
+        savedConnections = connectionsMap;
+        savedNodes = pendingNodes;
+    }
+
+    // seconds spent connecting the machine by the buffered path
+    double measureBuffered() {
+        restore();
+
+        auto begin = std::chrono::steady_clock::now();
+        processConnectionMap(model->getValvesIdsSet());
+        edgesNumber = edges.size();
+        addEdges();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    // seconds spent connecting the machine by the incremental path
+    double measureIncremental() {
+        restore();
+
+        auto begin = std::chrono::steady_clock::now();
+        processConnectionMapIncremental();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    size_t getEdgesNumber() const {
+        return edgesNumber;
+    }
+
+protected:
+    size_t edgesNumber;
+    std::unordered_map<int,std::unordered_map<float,int>> savedConnections;
+    std::vector<std::pair<int, NodeMaker>> savedNodes;
+
+    void restore() {
+        connectionsMap = savedConnections;
+        pendingNodes = savedNodes;
+        model = std::make_shared<MachineGraph>();
+        addPendingNodes();
+    }
+
+    //every block declares its port directions, so the generated machines are connected by the directed pass
+    void processConnectionMapIncremental() {
+        std::unordered_set<int> proccessed;
+
+        for(const auto & directionPair: directedConnectionsMapsIn) {
+            int source = directionPair.first;
+            const PortSet & inPorts = directionPair.second;
+            const PortSet & outPorts = directedConnectionsMapsOut.at(source);
+
+            auto connectionsFinded = connectionsMap.find(source);
+            if (connectionsFinded == connectionsMap.end()) {
+                proccessed.insert(source);
+                continue;
+            }
+            for(const auto & connectPair : connectionsFinded->second) {
+                int target = std::floor(connectPair.first);
+                float prime = connectPair.first - target;
+
+                int sourcePort = connectPair.second;
+                if (proccessed.find(target) != proccessed.end()) {
+                    continue;
+                }
+
+                int targetPort = getTargetPort(target, source, prime);
+                if(inPorts.contains(sourcePort)) {
+                    model->connectNodes(target, source, targetPort, sourcePort);
+                } else if (outPorts.contains(sourcePort)) {
+                    model->connectNodes(source, target, sourcePort, targetPort);
+                }
+            }
+            connectionsMap.erase(connectionsFinded);
+            proccessed.insert(source);
+        }
+
+        for(const auto & connectionPair: connectionsMap) {
+            int source = connectionPair.first;
+            for(const auto & portConnection: connectionPair.second) {
+                int target = std::floor(portConnection.first);
+                float prime = portConnection.first - target;
+
+                if (proccessed.find(target) == proccessed.end()) {
+                    model->connectNodes(source, target, portConnection.second, getTargetPort(target, source, prime));
+                }
+            }
+            proccessed.insert(source);
+        }
+    }
+};
+
+}
+
+int main(int argc, char* argv[]) {
+    int pumps = (argc > 1 ? std::atoi(argv[1]) : 20000);
+    int repetitions = (argc > 2 ? std::atoi(argv[2]) : 5);
+
+    std::string path = "edgeinsertionbenchmark.json";
+    try {
+        MachineGenerator::writeFile(MachineGenerator::makeChain(pumps), path);
+
+        EdgeInsertionBenchmark benchmark(path);
+        benchmark.prepare();
+
+        //the order alternates so neither path always runs on a warmer heap
+        double bestBuffered = std::numeric_limits<double>::max();
+        double bestIncremental = std::numeric_limits<double>::max();
+        for(int i = 0; i < repetitions; i++) {
+            if (i % 2 == 0) {
+                bestBuffered = std::min(bestBuffered, benchmark.measureBuffered());
+                bestIncremental = std::min(bestIncremental, benchmark.measureIncremental());
+            } else {
+                bestIncremental = std::min(bestIncremental, benchmark.measureIncremental());
+                bestBuffered = std::min(bestBuffered, benchmark.measureBuffered());
+            }
+        }
+
+        double edges = std::max<size_t>(benchmark.getEdgesNumber(), 1);
+        std::printf("edges: %zu, best of %d\n", benchmark.getEdgesNumber(), repetitions);
+        std::printf("buffered:    %.3f ms, %.1f ns/edge\n", bestBuffered * 1e3, bestBuffered * 1e9 / edges);
+        std::printf("incremental: %.3f ms, %.1f ns/edge\n", bestIncremental * 1e3, bestIncremental * 1e9 / edges);
+    } catch (std::exception & e) {
+        std::fprintf(stderr, "edgeinsertionbenchmark: %s\n", e.what());
+        std::remove(path.c_str());
+        return 1;
+    }
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,8 @@
+# compares JsonDocumentParser, with the backend it was built with, against the plain nlohmann parser
+
+include(../tests.pri)
+
+TARGET = jsonparsebenchmark
+
+SOURCES += \
+    main.cpp
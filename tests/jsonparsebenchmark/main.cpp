@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <string>
+
+#include "blocklyFluidicMachineTranslator/json/jsondocumentparser.h"
+#include "tests/common/machinegenerator.h"
+
+// usage: jsonparsebenchmark [pumps=20000] [repetitions=10]
+//
+// parses the text of the same machine with nlohmann::json::parse and with JsonDocumentParser, which uses simdjson
+// when the library was built with CONFIG += simdjson. Both build the nlohmann tree the translators navigate, no nesting
+// limit is set so only the backends are compared.
+
+namespace {
+
+// best seconds of all the repetitions
+double measure(int repetitions, const std::function<size_t()> & parse) {
+    double best = std::numeric_limits<double>::max();
+    size_t checksum = 0;
+    for(int i = 0; i < repetitions; i++) {
+        auto begin = std::chrono::steady_clock::now();
+        checksum += parse();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+    }
+    //the size of the documents is used so the parse can not be optimized away
+    if (checksum == 0) {
+        std::printf("empty documents\n");
+    }
+    return best;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int pumps = (argc > 1 ? std::atoi(argv[1]) : 20000);
+    int repetitions = (argc > 2 ? std::atoi(argv[2]) : 10);
+
+    try {
+        std::string text = MachineGenerator::makeChain(pumps).dump();
+        double megabytes = text.size() / (1024.0 * 1024.0);
+
+        JsonDocumentParser parser;
+        double nlohmannSeconds = measure(repetitions, [&text]() {
+            return nlohmann::json::parse(text)["connections"].size();
+        });
+        double parserSeconds = measure(repetitions, [&text, &parser]() {
+            return parser.parse(text)["connections"].size();
+        });
+
+        std::printf("document: %.1f MB, best of %d\n", megabytes, repetitions);
+        std::printf("nlohmann:           %.3f ms, %.1f MB/s\n", nlohmannSeconds * 1e3, megabytes / nlohmannSeconds);
+        std::printf("JsonDocumentParser: %.3f ms, %.1f MB/s, %s backend, %.2f times nlohmann\n",
+                    parserSeconds * 1e3, megabytes / parserSeconds,
+                    (JsonDocumentParser::isSimdBackendAvailable() ? "simdjson" : "nlohmann"),
+                    parserSeconds / nlohmannSeconds);
+    } catch (std::exception & e) {
+        std::fprintf(stderr, "jsonparsebenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "blocklyFluidicMachineTranslator/modules/modularmachinetranslator.h"
+#include "tests/common/machinegenerator.h"
+
+// splits generated machines in modules and checks that the link gives the same machine as the flat file, that only
+// the changed modules are translated again and that the malformed references are rejected
+
+using json = nlohmann::json;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string & message) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", message.c_str());
+        failures++;
+    }
+}
+
+std::string moduleName(int module) {
+    return "M" + std::to_string(module);
+}
+
+std::string modulePath(int module) {
+    return "modulartranslatortest_" + moduleName(module) + ".json";
+}
+
+// the blocks of the machine are dealt in consecutive runs to the modules, the references to blocks of other
+// modules are qualified, the unknown references are left as they are. Returns the path of the manifest.
+std::string writeModules(const json & machine, int modulesNumber) {
+    const json & blocks = machine["connections"];
+    size_t blocksPerModule = (blocks.size() + modulesNumber - 1) / modulesNumber;
+
+    std::map<std::string, int> blockModule;
+    for(size_t i = 0; i < blocks.size(); i++) {
+        blockModule[blocks[i]["reference"].get<std::string>()] = i / blocksPerModule;
+    }
+
+    std::vector<json> modules(modulesNumber, json::object());
+    for(json & module : modules) {
+        module["connections"] = json::array();
+    }
+    for(size_t i = 0; i < blocks.size(); i++) {
+        int module = i / blocksPerModule;
+        json block = blocks[i];
+        for(auto it = block.begin(); it != block.end(); ++it) {
+            if (it.key().compare(0, 4, "port") == 0 && it.value().is_object()) {
+                std::string reference = it.value()["reference"];
+                auto target = blockModule.find(reference);
+                if (target != blockModule.end() && target->second != module) {
+                    it.value()["reference"] = moduleName(target->second) + "::" + reference;
+                }
+            }
+        }
+        modules[module]["connections"].push_back(block);
+    }
+
+    json manifest = machine;
+    manifest.erase("connections");
+    manifest.erase("number_blocks");
+    manifest["modules"] = json::array();
+    for(int module = 0; module < modulesNumber; module++) {
+        MachineGenerator::writeFile(modules[module], modulePath(module));
+        manifest["modules"].push_back({{"name", moduleName(module)}, {"path", modulePath(module)}});
+    }
+
+    std::string manifestPath = "modulartranslatortest_manifest.json";
+    MachineGenerator::writeFile(manifest, manifestPath);
+    return manifestPath;
+}
+
+bool throwsInvalidArgument(ModularMachineTranslator & translator) {
+    try {
+        translator.translateModules();
+    } catch (std::invalid_argument & e) {
+        return true;
+    }
+    return false;
+}
+
+void testLink() {
+    const int modulesNumber = 4;
+    json machine = MachineGenerator::makeChain(50);
+
+    std::string flatPath = "modulartranslatortest_flat.json";
+    MachineGenerator::writeFile(machine, flatPath);
+    BlocklyFluidicMachineTranslator flatTranslator(flatPath, std::shared_ptr<PluginAbstractFactory>());
+    MachineFingerprint flatFingerprint;
+    flatTranslator.translateFile(flatFingerprint);
+    std::remove(flatPath.c_str());
+
+    std::string manifestPath = writeModules(machine, modulesNumber);
+    std::shared_ptr<ModuleCache> cache = std::make_shared<ModuleCache>();
+
+    ModularMachineTranslator translator(manifestPath, std::shared_ptr<PluginAbstractFactory>(), cache);
+    translator.setFingerprintEnabled(true);
+    translator.translateModules();
+    check(translator.getFingerprint() == flatFingerprint, "the linked machine differs from the flat one");
+    check(translator.getVariableIdMap().size() == machine["connections"].size(), "unexpected number of linked references");
+    check(translator.getVariableIdMap().count("M0::c0") == 1, "references are not qualified by their module");
+    check(cache->getMisses() == modulesNumber && cache->getHits() == 0, "every module is translated the first time");
+
+    //nothing changed, only the link runs again
+    translator.setThreadsNumber(1);
+    translator.translateModules();
+    check(translator.getFingerprint() == flatFingerprint, "the machine linked from the cache differs from the flat one");
+    check(cache->getMisses() == modulesNumber && cache->getHits() == modulesNumber, "unchanged modules are translated again");
+
+    //a change in one module only translates that module again
+    json changedModule;
+    {
+        std::ifstream in(modulePath(2));
+        in >> changedModule;
+    }
+    changedModule["comment"] = "changed";
+    MachineGenerator::writeFile(changedModule, modulePath(2));
+
+    translator.setThreadsNumber(modulesNumber);
+    translator.translateModules();
+    check(translator.getFingerprint() == flatFingerprint, "the relinked machine differs from the flat one");
+    check(cache->getMisses() == modulesNumber + 1 && cache->getHits() == 2 * modulesNumber - 1,
+          "only the changed module has to be translated again");
+
+    //other translators sharing the cache reuse the modules too
+    ModularMachineTranslator otherTranslator(manifestPath, std::shared_ptr<PluginAbstractFactory>(), cache);
+    otherTranslator.setFingerprintEnabled(true);
+    otherTranslator.translateModules();
+    check(otherTranslator.getVariableIdMap() == translator.getVariableIdMap(), "the link is not deterministic");
+    check(cache->getMisses() == modulesNumber + 1, "a shared cache is not reused");
+
+    for(int module = 0; module < modulesNumber; module++) {
+        std::remove(modulePath(module).c_str());
+    }
+    std::remove(manifestPath.c_str());
+}
+
+void testRejectedReferences() {
+    json machine = MachineGenerator::makeChain(2);
+
+    //a block can not define a reference of another module
+    json qualifiedBlock = machine;
+    qualifiedBlock["connections"][0]["reference"] = "M1::c0";
+    std::string manifestPath = writeModules(qualifiedBlock, 1);
+    ModularMachineTranslator qualifiedTranslator(manifestPath, std::shared_ptr<PluginAbstractFactory>());
+    check(throwsInvalidArgument(qualifiedTranslator), "a local reference with \"::\" is accepted");
+
+    //references to modules or blocks that do not exist
+    json unknownModule = machine;
+    unknownModule["connections"][0]["port1"]["reference"] = "M9::p0";
+    manifestPath = writeModules(unknownModule, 1);
+    ModularMachineTranslator unknownTranslator(manifestPath, std::shared_ptr<PluginAbstractFactory>());
+    check(throwsInvalidArgument(unknownTranslator), "a reference to an unknown module is accepted");
+
+    std::remove(modulePath(0).c_str());
+    std::remove(manifestPath.c_str());
+}
+
+void testInputLimit() {
+    std::string manifestPath = writeModules(MachineGenerator::makeChain(20), 1);
+
+    TranslationLimits limits;
+    limits.maxInputBytes = 1024;
+    ModularMachineTranslator translator(manifestPath, std::shared_ptr<PluginAbstractFactory>());
+    translator.setLimits(limits);
+    check(throwsInvalidArgument(translator), "a module larger than maxInputBytes is accepted");
+
+    std::remove(modulePath(0).c_str());
+    std::remove(manifestPath.c_str());
+}
+
+}
+
+int main() {
+    try {
+        testLink();
+        testRejectedReferences();
+        testInputLimit();
+    } catch (std::exception & e) {
+        std::fprintf(stderr, "FAILED: %s\n", e.what());
+        failures++;
+    }
+
+    if (failures > 0) {
+        std::fprintf(stderr, "modulartranslatortest: %d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("modulartranslatortest: passed\n");
+    return 0;
+}
@@ -0,0 +1,9 @@
+# links machines split in modules and checks the ModuleCache reuse
+
+include(../tests.pri)
+
+TARGET = modulartranslatortest
+CONFIG += testcase
+
+SOURCES += \
+    main.cpp
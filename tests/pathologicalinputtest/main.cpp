@@ -0,0 +1,328 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "tests/common/machinegenerator.h"
+
+// translates machines built to hit the worst case of every input driven path with the default TranslationLimits. Each
+// one has to be either translated or rejected with an invalid_argument, as expected, within MAX_SECONDS and without the
+// peak memory going over MAX_PEAK_MEMORY. The peak of a process never goes down, so the inputs are generated here and
+// every case is translated by a new process running this program with the index of the case.
+
+using json = nlohmann::json;
+
+namespace {
+
+const double MAX_SECONDS = 10;
+const size_t MAX_PEAK_MEMORY = 512 * 1024 * 1024;
+
+const std::string PLACEHOLDER_STR = "\"@@placeholder@@\"";
+
+struct PathologicalCase {
+    std::string name;
+    std::function<std::string()> makeText;
+    bool rejected;
+};
+
+// peak resident memory of the process in bytes
+size_t getPeakMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// the deepest documents can not be built as json objects, their nesting is spliced in place of a placeholder value
+std::string replacePlaceholder(const json & machine, const std::string & text) {
+    std::string machineText = machine.dump();
+    size_t position = machineText.find(PLACEHOLDER_STR);
+    return machineText.replace(position, PLACEHOLDER_STR.size(), text);
+}
+
+std::string nested(const std::string & prefix, const std::string & inner, const std::string & suffix, int depth) {
+    std::string text;
+    text.reserve((prefix.size() + suffix.size()) * depth + inner.size());
+    for(int i = 0; i < depth; i++) {
+        text += prefix;
+    }
+    text += inner;
+    for(int i = 0; i < depth; i++) {
+        text += suffix;
+    }
+    return text;
+}
+
+json makePartCopy(const json & reference, int depth) {
+    json referenceObj = reference;
+    for(int i = 0; i < depth; i++) {
+        referenceObj = {{"block_type", "part_copy"}, {"reference", referenceObj}};
+    }
+    return referenceObj;
+}
+
+std::string makeDeepPartCopy() {
+    json machine = MachineGenerator::makeChain(1);
+    machine["connections"][1]["port1"] = "@@placeholder@@";
+    return replacePlaceholder(machine, nested("{\"block_type\":\"part_copy\",\"reference\":", "{\"reference\":\"c0\"}", "}", 100000));
+}
+
+std::string makeTenPartCopies() {
+    json machine = MachineGenerator::makeChain(1);
+    machine["connections"][1]["port1"] = makePartCopy(MachineGenerator::makeReference("c0"), 10);
+    return machine.dump();
+}
+
+// pairs of valves connected to each other, the first one is twin of all the others
+std::string makeManyTwins() {
+    const int valves = 4000;
+    json machine = MachineGenerator::makeMachine();
+    auto valve = [](int i) { return "v" + std::to_string(i); };
+
+    json truthTable = json::array({{{"position", 0}, {"connected_pins", {{0, 1}}}}});
+    for(int i = 0; i < valves; i++) {
+        //both pins reach the same valve, the second one through a copy of the reference
+        json pair = MachineGenerator::makeReference(valve(i % 2 == 0 ? i + 1 : i - 1));
+        machine["connections"].push_back(MachineGenerator::makeValve(valve(i), {1}, {2}, {pair, makePartCopy(pair, 1)}, truthTable));
+    }
+
+    json & first = machine["connections"][0];
+    first["number_twins"] = valves - 1;
+    for(int i = 1; i < valves; i++) {
+        first["twin" + std::to_string(i)] = MachineGenerator::makeReference(valve(i));
+    }
+    return machine.dump();
+}
+
+// a valve with as many pins as allowed to a node, every row of its truth table connects all of them
+std::string makeWideTruthTable() {
+    const int pins = 1024;
+    json machine = MachineGenerator::makeMachine();
+    auto container = [](int i) { return "c" + std::to_string(i); };
+
+    json allPins = json::array();
+    for(int pin = 0; pin < pins; pin++) {
+        allPins.push_back(pin);
+    }
+    json truthTable = json::array();
+    for(int position = 0; position < pins; position++) {
+        truthTable.push_back({{"position", position}, {"connected_pins", json::array({allPins})}});
+    }
+
+    std::vector<int> outPorts;
+    std::vector<json> ports;
+    for(int i = 0; i < pins; i++) {
+        outPorts.push_back(i + 1);
+        ports.push_back(MachineGenerator::makeReference(container(i)));
+        machine["connections"].push_back(
+                    MachineGenerator::makeContainer(container(i), false, {1}, {}, {MachineGenerator::makeReference("v")}));
+    }
+    machine["connections"].push_back(MachineGenerator::makeValve("v", {}, outPorts, ports, truthTable));
+    return machine.dump();
+}
+
+// every pump feeds its own pin of a single container
+std::string makeHugeFanIn() {
+    const int pumps = 1000;
+    json machine = MachineGenerator::makeMachine();
+    auto source = [](int i) { return "s" + std::to_string(i); };
+    auto pump = [](int i) { return "p" + std::to_string(i); };
+
+    std::vector<int> inPorts;
+    std::vector<json> ports;
+    for(int i = 0; i < pumps; i++) {
+        machine["connections"].push_back(
+                    MachineGenerator::makeContainer(source(i), true, {}, {1}, {MachineGenerator::makeReference(pump(i))}));
+        machine["connections"].push_back(
+                    MachineGenerator::makePump(pump(i), MachineGenerator::makeReference(source(i)), MachineGenerator::makeReference("sink")));
+        inPorts.push_back(i + 1);
+        ports.push_back(MachineGenerator::makeReference(pump(i)));
+    }
+    machine["connections"].push_back(MachineGenerator::makeContainer("sink", false, inPorts, {}, ports));
+    return machine.dump();
+}
+
+json makeNumber(int value) {
+    return {{"block_type", "math_number"}, {"value", std::to_string(value)}};
+}
+
+json makeNumberList(const json & numbers) {
+    return {{"block_type", "number_list"}, {"containerList", numbers}};
+}
+
+std::string makeLongNumberList() {
+    json numbers = json::array();
+    for(int i = 0; i < 100000; i++) {
+        numbers.push_back(makeNumber(i));
+    }
+
+    json machine = MachineGenerator::makeChain(1);
+    json & functions = machine["connections"][1]["functions"];
+    functions["paramsNumber"] = 1;
+    functions["name0"] = "list";
+    functions["value0"] = makeNumberList(numbers);
+    return machine.dump();
+}
+
+std::string makeNestedNumberList() {
+    json input = makeNumber(0);
+    for(int i = 0; i < 100; i++) {
+        input = makeNumberList(json::array({input}));
+    }
+
+    json machine = MachineGenerator::makeChain(1);
+    json & functions = machine["connections"][1]["functions"];
+    functions["paramsNumber"] = 1;
+    functions["name0"] = "list";
+    functions["value0"] = input;
+    return machine.dump();
+}
+
+// the pumps point to the containers but the containers do not point back to the pumps filling them
+std::string makeAsymmetricReferences() {
+    json machine = MachineGenerator::makeChain(100);
+    for(json & block : machine["connections"]) {
+        if (block["type"] == "CLOSE_CONTAINER" && block.count("port2") > 0) {
+            block["port1"] = block["port2"];
+        }
+    }
+    return machine.dump();
+}
+
+// just under the blocks allowed, every pump and every container equal to the others
+std::string makeLongChain() {
+    return MachineGenerator::makeChain(49999).dump();
+}
+
+// twice the blocks allowed, rejected while the document is parsed
+std::string makeTooManyBlocks() {
+    return MachineGenerator::makeChain(100000).dump();
+}
+
+// cut in the middle of a block, the parse error has to come back as a rejection
+std::string makeTruncatedDocument() {
+    std::string text = MachineGenerator::makeChain(100).dump();
+    return text.substr(0, text.size() / 2);
+}
+
+std::string makeDeepDocument() {
+    json machine = MachineGenerator::makeChain(1);
+    machine["comment"] = "@@placeholder@@";
+    return replacePlaceholder(machine, nested("[", "", "]", 1000000));
+}
+
+std::vector<PathologicalCase> makeCorpus() {
+    return {
+        {"deep part_copy", makeDeepPartCopy, true},
+        {"ten part copies", makeTenPartCopies, true},
+        {"many twins", makeManyTwins, false},
+        {"wide truth table", makeWideTruthTable, false},
+        {"huge fan-in", makeHugeFanIn, false},
+        {"long number_list", makeLongNumberList, false},
+        {"nested number_list", makeNestedNumberList, true},
+        {"asymmetric references", makeAsymmetricReferences, true},
+        {"deep document", makeDeepDocument, true},
+        {"truncated document", makeTruncatedDocument, true},
+        {"long chain", makeLongChain, false},
+        {"too many blocks", makeTooManyBlocks, true},
+    };
+}
+
+std::string casePath(size_t index) {
+    return "pathologicalinputtest_" + std::to_string(index) + ".json";
+}
+
+// translates the file of the case, returns true if it behaved as expected
+bool runCase(size_t index) {
+    PathologicalCase pathologicalCase = makeCorpus().at(index);
+
+    auto begin = std::chrono::steady_clock::now();
+    bool rejected = false;
+    std::string message;
+    try {
+        //the fingerprint is requested too, its refinement is driven by the input as much as the translation
+        BlocklyFluidicMachineTranslator translator(casePath(index), std::shared_ptr<PluginAbstractFactory>());
+        MachineFingerprint fingerprint;
+        translator.translateFile(fingerprint);
+    } catch (std::invalid_argument & e) {
+        rejected = true;
+        message = e.what();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    size_t peakMemory = getPeakMemory();
+
+    bool passed = (rejected == pathologicalCase.rejected && seconds <= MAX_SECONDS && peakMemory <= MAX_PEAK_MEMORY);
+    std::printf("%-24s %-10s %8.3f s %8.1f MB  %s\n",
+                pathologicalCase.name.c_str(),
+                rejected ? "rejected" : "translated",
+                seconds,
+                peakMemory / (1024.0 * 1024.0),
+                passed ? "ok" : "FAILED");
+    if (!passed && !message.empty()) {
+        std::fprintf(stderr, "%s: %s\n", pathologicalCase.name.c_str(), message.substr(message.size() > 512 ? message.size() - 512 : 0).c_str());
+    }
+    std::fflush(stdout);
+    return passed;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        try {
+            return runCase(std::stoul(argv[1])) ? 0 : 1;
+        } catch (std::exception & e) {
+            std::fprintf(stderr, "FAILED: case %s: %s\n", argv[1], e.what());
+            return 1;
+        }
+    }
+
+    int failures = 0;
+    std::vector<PathologicalCase> corpus = makeCorpus();
+    for(size_t index = 0; index < corpus.size(); index++) {
+        try {
+            std::ofstream out(casePath(index), std::ios::out | std::ios::binary | std::ios::trunc);
+            out << corpus[index].makeText();
+            out.close();
+
+            std::string command = "\"" + std::string(argv[0]) + "\" " + std::to_string(index);
+            if (std::system(command.c_str()) != 0) {
+                failures++;
+            }
+        } catch (std::exception & e) {
+            std::fprintf(stderr, "FAILED: %s: %s\n", corpus[index].name.c_str(), e.what());
+            failures++;
+        }
+        std::remove(casePath(index).c_str());
+    }
+
+    if (failures > 0) {
+        std::fprintf(stderr, "pathologicalinputtest: %d cases failed\n", failures);
+        return 1;
+    }
+    std::printf("pathologicalinputtest: passed\n");
+    return 0;
+}
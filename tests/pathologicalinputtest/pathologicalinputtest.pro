@@ -0,0 +1,11 @@
+# translates a corpus of worst-case machines and checks every one is handled within a time and a memory bound
+
+include(../tests.pri)
+
+TARGET = pathologicalinputtest
+CONFIG += testcase
+
+win32: LIBS += -lpsapi
+
+SOURCES += \
+    main.cpp
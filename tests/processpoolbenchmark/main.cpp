@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "blocklyFluidicMachineTranslator/blocklyfluidicmachinetranslator.h"
+#include "blocklyFluidicMachineTranslator/process/translationprocesspool.h"
+#include "tests/common/machinegenerator.h"
+
+// usage: processpoolbenchmark [--counters] [workers=hardware threads] [translations=200] [pumps=500]
+//
+// translates the same machine up to the FluidicMachineModel "translations" times, first with "workers" threads, each
+// one with its own translator, and then with "workers" threads sending the translations to a pool of "workers"
+// processes, which build the model in the worker. Every request is timed on its own, so besides the throughput the
+// median and the 99th percentile latency of both modes are printed. The ratio is the cost of the isolation: sending the
+// path, translating in the worker and returning the result.
+// With --counters one more translation runs in this process with the hardware counters enabled and prints them per
+// phase, the counters of a worker stay in the worker.
+
+namespace {
+
+struct Measure {
+    double seconds;
+    // seconds of every request that succeeded
+    std::vector<double> latencies;
+    int failures;
+    std::string firstError;
+};
+
+// runs all the translations with threadsNumber threads, a failed translation is counted and the rest go on
+Measure measure(int threadsNumber, int translations, const std::function<void()> & translate) {
+    std::atomic<int> nextTranslation(0);
+    std::vector<std::thread> threads;
+    std::vector<std::vector<double>> threadLatencies(threadsNumber);
+
+    Measure result;
+    result.failures = 0;
+    std::mutex errorMutex;
+
+    auto begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < threadsNumber; i++) {
+        std::vector<double> & latencies = threadLatencies[i];
+        threads.emplace_back([translations, &nextTranslation, &translate, &latencies, &result, &errorMutex]() {
+            while (nextTranslation.fetch_add(1) < translations) {
+                auto requestBegin = std::chrono::steady_clock::now();
+                try {
+                    translate();
+                    latencies.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - requestBegin).count());
+                } catch (std::exception & e) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (result.failures == 0) {
+                        result.firstError = e.what();
+                    }
+                    result.failures++;
+                }
+            }
+        });
+    }
+    for(std::thread & thread : threads) {
+        thread.join();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    for(const std::vector<double> & latencies : threadLatencies) {
+        result.latencies.insert(result.latencies.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+// nearest rank percentile of the sorted latencies, in milliseconds
+double percentile(const std::vector<double> & latencies, double fraction) {
+    if (latencies.empty()) {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>(fraction * latencies.size() + 0.999999);
+    return latencies[std::min(std::max<size_t>(rank, 1), latencies.size()) - 1] * 1e3;
+}
+
+// prints the measure and returns its failures
+int report(const char * name, const Measure & result, int translations) {
+    std::printf("%s %.3f s, %.1f translations/s, p50 %.3f ms, p99 %.3f ms\n",
+                name, result.seconds, translations / result.seconds,
+                percentile(result.latencies, 0.5), percentile(result.latencies, 0.99));
+    if (result.failures > 0) {
+        std::fprintf(stderr, "%s %d translations failed, first: %s\n", name, result.failures, result.firstError.c_str());
+    }
+    return result.failures;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    bool counters = false;
+    std::vector<char*> args;
+    for(int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--counters") {
+            counters = true;
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    int workers = (args.size() > 0 ? std::atoi(args[0]) : std::max<int>(std::thread::hardware_concurrency(), 1));
+    int translations = (args.size() > 1 ? std::atoi(args[1]) : 200);
+    int pumps = (args.size() > 2 ? std::atoi(args[2]) : 500);
+
+    std::string path = "processpoolbenchmark.json";
+    int failures = 0;
+    try {
+        MachineGenerator::writeFile(MachineGenerator::makeChain(pumps), path);
+
+        std::shared_ptr<const TranslationContext> context =
+                std::make_shared<const TranslationContext>(std::shared_ptr<PluginAbstractFactory>(),
+                                                           NodeReordering::reference_order,
+                                                           std::make_shared<TranslationStackPool>(workers));
+        //the pool forks its spawner, so it is built before any thread is started
+        TranslationProcessPool pool(context, workers);
+
+        auto translateInThread = [&path, context]() {
+            BlocklyFluidicMachineTranslator translator(path, context);
+            translator.translateFile();
+        };
+        auto translateInProcess = [&path, &pool]() {
+            pool.translateModel(path);
+        };
+
+        //warms the function tables, the stack pool and every worker
+        measure(1, 1, translateInThread);
+        measure(workers, workers, translateInProcess);
+
+        std::printf("translations: %d, pumps: %d, workers: %d\n", translations, pumps, workers);
+        Measure threadMeasure = measure(workers, translations, translateInThread);
+        failures += report("threads:  ", threadMeasure, translations);
+        Measure processMeasure = measure(workers, translations, translateInProcess);
+        failures += report("processes:", processMeasure, translations);
+        std::printf("processes take %.2f times the threads, p99 %.2f times\n",
+                    processMeasure.seconds / threadMeasure.seconds,
+                    percentile(processMeasure.latencies, 0.99) / std::max(percentile(threadMeasure.latencies, 0.99), 1e-9));
+
+        if (counters) {
+            //kept out of the timings, the counters are read at every phase change
+            BlocklyFluidicMachineTranslator translator(path, context);
+            translator.setHardwareCountersEnabled(true);
+            translator.translateFile();
+            std::printf("%s", translator.getPhaseCounters()->toString().c_str());
+        }
+    } catch (std::exception & e) {
+        std::fprintf(stderr, "processpoolbenchmark: %s\n", e.what());
+        std::remove(path.c_str());
+        return 1;
+    }
+    std::remove(path.c_str());
+    return (failures > 0 ? 1 : 0);
+}
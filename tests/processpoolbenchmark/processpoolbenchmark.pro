@@ -0,0 +1,8 @@
+# compares the throughput and the latency of translating in threads against translating in a TranslationProcessPool
+
+include(../tests.pri)
+
+TARGET = processpoolbenchmark
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,76 @@
+# settings shared by every test and benchmark, included from their .pro files
+
+# ensure one "debug" or "release" in CONFIG so they can be used as conditionals, as the library does
+CONFIG(debug, debug|release) {
+    CONFIG -= debug release
+    CONFIG += debug
+}
+CONFIG(release, debug|release) {
+    CONFIG -= debug release
+    CONFIG += release
+}
+
+QT       -= gui
+
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/..
+
+HEADERS += \
+    $$PWD/common/machinegenerator.h
+
+SOURCES += \
+    $$PWD/common/machinegenerator.cpp
+
+# folder where the library was built, by default the shadow build of BlocklyFluidicMachineTranslator.pro next to
+# the one of the tests: qmake BLOCKLYTRANSLATOR_BUILD_DIR=<folder> to change it
+isEmpty(BLOCKLYTRANSLATOR_BUILD_DIR) {
+    BLOCKLYTRANSLATOR_BUILD_DIR = $$OUT_PWD/../..
+}
+
+debug {
+    LIBS += -L$$quote($$BLOCKLYTRANSLATOR_BUILD_DIR/debug) -L$$quote($$BLOCKLYTRANSLATOR_BUILD_DIR) -lblocklyFluidicMachineTranslator
+
+    INCLUDEPATH += X:\fluidicMachineModel\dll_debug\include
+    LIBS += -L$$quote(X:\fluidicMachineModel\dll_debug\bin) -lFluidicMachineModel
+
+    INCLUDEPATH += X:\constraintsEngine\dll_debug\include
+    LIBS += -L$$quote(X:\constraintsEngine\dll_debug\bin) -lconstraintsEngineLibrary
+
+    INCLUDEPATH += X:\utils\dll_debug\include
+    LIBS += -L$$quote(X:\utils\dll_debug\bin) -lutils
+
+    INCLUDEPATH += X:\commomModel\dll_debug\include
+    LIBS += -L$$quote(X:\commomModel\dll_debug\bin) -lcommonModel
+
+    INCLUDEPATH += X:\fluidicModelMapping\dll_debug\include
+    LIBS += -L$$quote(X:\fluidicModelMapping\dll_debug\bin) -lFluidicModelMapping
+}
+
+!debug {
+    LIBS += -L$$quote($$BLOCKLYTRANSLATOR_BUILD_DIR/release) -L$$quote($$BLOCKLYTRANSLATOR_BUILD_DIR) -lblocklyFluidicMachineTranslator
+
+    INCLUDEPATH += X:\fluidicMachineModel\dll_release\include
+    LIBS += -L$$quote(X:\fluidicMachineModel\dll_release\bin) -lFluidicMachineModel
+
+    INCLUDEPATH += X:\constraintsEngine\dll_release\include
+    LIBS += -L$$quote(X:\constraintsEngine\dll_release\bin) -lconstraintsEngineLibrary
+
+    INCLUDEPATH += X:\utils\dll_release\include
+    LIBS += -L$$quote(X:\utils\dll_release\bin) -lutils
+
+    INCLUDEPATH += X:\commomModel\dll_release\include
+    LIBS += -L$$quote(X:\commomModel\dll_release\bin) -lcommonModel
+
+    INCLUDEPATH += X:\fluidicModelMapping\dll_release\include
+    LIBS += -L$$quote(X:\fluidicModelMapping\dll_release\bin) -lFluidicModelMapping
+}
+
+INCLUDEPATH += X:\libraries\cereal-1.2.2\include
+INCLUDEPATH += X:\libraries\json-2.1.1\src
+
+INCLUDEPATH += X:\swipl\include
+LIBS += -L$$quote(X:\swipl\bin) -llibswipl
+LIBS += -L$$quote(X:\swipl\lib) -llibswipl
@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# tests and benchmarks of the translator, built against the library of the parent project:
+#   qmake tests.pro && make && make check
+#
+# "make check" runs the targets marked as testcase, the benchmarks only print their timings and are run by hand
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    concurrenttranslationbenchmark \
+    concurrenttranslationtest \
+    edgeinsertionbenchmark \
+    jsonparsebenchmark \
+    modulartranslatortest \
+    pathologicalinputtest
+
+# the process pool needs fork and unix sockets
+unix: SUBDIRS += processpoolbenchmark